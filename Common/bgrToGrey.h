@@ -0,0 +1,367 @@
+/**
+********************************************************************************
+*
+*   @file       bgrToGrey.h
+*
+*   @brief      Conversion of 8-bit BGR images (as returned by cv::imread) to
+*               greyscale, Y = 0.114 B + 0.587 G + 0.299 R, using the same
+*               Q14 fixed-point weights as cv::cvtColor(..., COLOR_BGR2GRAY),
+*               so that the results are identical.
+*
+*               The output is either 8-bit, or float in [0, 1] (Y / 255),
+*               which replaces cvtColor + convertTo with a single pass. The
+*               min/max stretch of cv::normalize is a lookup table, see
+*               contrastStretchFloat and PointOperation::contrastStretch
+*               (pointOperation.h). On x86, rows are processed 16 pixels at a
+*               time with AVX2 or SSE4.1, chosen at run time with
+*               cv::checkHardwareSupport: the kernels are compiled for their
+*               instruction set with the target attribute (GCC and Clang), so
+*               no -mavx2 or -msse4.1 flag is needed, and the program still
+*               runs on older processors. The scalar code handles the other
+*               processors and the end of the rows.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef BGR_TO_GREY_H
+#define BGR_TO_GREY_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BGR_TO_GREY_X86
+#include <immintrin.h> // Header for the SSE4.1 and AVX2 intrinsics
+
+// Compile a function for an instruction set that the other functions may
+// not use. MSVC accepts the intrinsics of any instruction set.
+#if defined(__GNUC__)
+#define BGR_TO_GREY_TARGET(instruction_set) __attribute__((target(instruction_set)))
+#else
+#define BGR_TO_GREY_TARGET(instruction_set)
+#endif
+#endif
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Weights of the blue, green and red channels in Q14 fixed point
+const int BGR_TO_GREY_B_WEIGHT = 1868;
+const int BGR_TO_GREY_G_WEIGHT = 9617;
+const int BGR_TO_GREY_R_WEIGHT = 4899;
+const int BGR_TO_GREY_SHIFT    = 14;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Greyscale value of a BGR pixel.
+inline unsigned char bgrToGreyPixel(unsigned char b, unsigned char g, unsigned char r);
+
+#ifdef BGR_TO_GREY_X86
+/// Instruction set of the row kernel: 2 for AVX2, 1 for SSE4.1, 0 for the
+/// scalar code. The processor is only queried once.
+inline int getBgrToGreyInstructionSet();
+
+/// Convert the first pixels of a row, 16 at a time, and return their number.
+BGR_TO_GREY_TARGET("avx2")
+inline int bgrToGreyRowAVX2(const unsigned char* p_bgr, unsigned char* p_grey, float* p_float, int width);
+
+BGR_TO_GREY_TARGET("sse4.1")
+inline int bgrToGreyRowSSE41(const unsigned char* p_bgr, unsigned char* p_grey, float* p_float, int width);
+#endif
+
+/// Convert a row of width BGR pixels. Either p_grey (8-bit) or p_float
+/// (float in [0, 1]) can be null.
+inline void bgrToGreyRow(const unsigned char* p_bgr,
+                         unsigned char* p_grey,
+                         float* p_float,
+                         int width);
+
+/// Convert a CV_8UC3 BGR image into a CV_8UC1 image. A CV_8UC1 input is
+/// copied.
+inline void bgrToGrey(const cv::Mat& src, cv::Mat& dst);
+
+/// Convert a CV_8UC3 BGR image (or a CV_8UC1 image) into a CV_32FC1 image
+/// in [0, 1].
+inline void bgrToGreyFloat(const cv::Mat& src, cv::Mat& dst);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//------------------------------------------------------------------------------------
+inline unsigned char bgrToGreyPixel(unsigned char b, unsigned char g, unsigned char r)
+//------------------------------------------------------------------------------------
+{
+    return static_cast<unsigned char>((b * BGR_TO_GREY_B_WEIGHT +
+                                       g * BGR_TO_GREY_G_WEIGHT +
+                                       r * BGR_TO_GREY_R_WEIGHT +
+                                       (1 << (BGR_TO_GREY_SHIFT - 1))) >> BGR_TO_GREY_SHIFT);
+}
+
+
+#ifdef BGR_TO_GREY_X86
+//------------------------------------------------------------------------------
+BGR_TO_GREY_TARGET("sse4.1")
+inline void deinterleaveBGR(const unsigned char* p_bgr,
+                            __m128i& b,
+                            __m128i& g,
+                            __m128i& r)
+//------------------------------------------------------------------------------
+{
+    // 16 pixels are spread over 3 registers
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(p_bgr));
+    __m128i v1 = _mm_loadu_si128((const __m128i*)(p_bgr + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i*)(p_bgr + 32));
+
+    // Gather each channel from the 3 registers (-1 clears the byte)
+    b = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(v0, _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13)));
+
+    g = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(v0, _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14)));
+
+    r = _mm_or_si128(_mm_or_si128(
+        _mm_shuffle_epi8(v0, _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(v1, _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1))),
+        _mm_shuffle_epi8(v2, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15)));
+}
+
+
+//-------------------------------------
+inline int getBgrToGreyInstructionSet()
+//-------------------------------------
+{
+    // Initialised once, even by several threads
+    static const int instruction_set(cv::checkHardwareSupport(CV_CPU_AVX2) ? 2 :
+                                     cv::checkHardwareSupport(CV_CPU_SSE4_1) ? 1 : 0);
+    return instruction_set;
+}
+
+
+//-------------------------------------------------------------------------------------------------------
+BGR_TO_GREY_TARGET("avx2")
+inline int bgrToGreyRowAVX2(const unsigned char* p_bgr, unsigned char* p_grey, float* p_float, int width)
+//-------------------------------------------------------------------------------------------------------
+{
+    int x(0);
+    const float scale(1.0f / 255.0f);
+
+    // Pairs of 16-bit weights: (B, G) and (R, rounding constant)
+    const __m256i bg_weights = _mm256_set1_epi32(BGR_TO_GREY_B_WEIGHT | (BGR_TO_GREY_G_WEIGHT << 16));
+    const __m256i r1_weights = _mm256_set1_epi32(BGR_TO_GREY_R_WEIGHT | ((1 << (BGR_TO_GREY_SHIFT - 1)) << 16));
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256 float_scale = _mm256_set1_ps(scale);
+
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i b, g, r;
+        deinterleaveBGR(p_bgr + 3 * x, b, g, r);
+
+        __m256i b16 = _mm256_cvtepu8_epi16(b);
+        __m256i g16 = _mm256_cvtepu8_epi16(g);
+        __m256i r16 = _mm256_cvtepu8_epi16(r);
+
+        // Within each 128-bit lane: pixels 0-3 (low) and 4-7 (high)
+        __m256i y_low = _mm256_srli_epi32(_mm256_add_epi32(
+            _mm256_madd_epi16(_mm256_unpacklo_epi16(b16, g16), bg_weights),
+            _mm256_madd_epi16(_mm256_unpacklo_epi16(r16, one), r1_weights)), BGR_TO_GREY_SHIFT);
+
+        __m256i y_high = _mm256_srli_epi32(_mm256_add_epi32(
+            _mm256_madd_epi16(_mm256_unpackhi_epi16(b16, g16), bg_weights),
+            _mm256_madd_epi16(_mm256_unpackhi_epi16(r16, one), r1_weights)), BGR_TO_GREY_SHIFT);
+
+        if (p_grey)
+        {
+            // The in-lane pack restores the order of the pixels
+            __m256i y16 = _mm256_packs_epi32(y_low, y_high);
+            _mm_storeu_si128((__m128i*)(p_grey + x),
+                _mm_packus_epi16(_mm256_castsi256_si128(y16), _mm256_extracti128_si256(y16, 1)));
+        }
+
+        if (p_float)
+        {
+            __m256i y_0_7  = _mm256_permute2x128_si256(y_low, y_high, 0x20);
+            __m256i y_8_15 = _mm256_permute2x128_si256(y_low, y_high, 0x31);
+            _mm256_storeu_ps(p_float + x,     _mm256_mul_ps(_mm256_cvtepi32_ps(y_0_7),  float_scale));
+            _mm256_storeu_ps(p_float + x + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(y_8_15), float_scale));
+        }
+    }
+
+    return x;
+}
+
+
+//--------------------------------------------------------------------------------------------------------
+BGR_TO_GREY_TARGET("sse4.1")
+inline int bgrToGreyRowSSE41(const unsigned char* p_bgr, unsigned char* p_grey, float* p_float, int width)
+//--------------------------------------------------------------------------------------------------------
+{
+    int x(0);
+    const float scale(1.0f / 255.0f);
+
+    // Pairs of 16-bit weights: (B, G) and (R, rounding constant)
+    const __m128i bg_weights = _mm_set1_epi32(BGR_TO_GREY_B_WEIGHT | (BGR_TO_GREY_G_WEIGHT << 16));
+    const __m128i r1_weights = _mm_set1_epi32(BGR_TO_GREY_R_WEIGHT | ((1 << (BGR_TO_GREY_SHIFT - 1)) << 16));
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128 float_scale = _mm_set1_ps(scale);
+
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i b, g, r;
+        deinterleaveBGR(p_bgr + 3 * x, b, g, r);
+
+        __m128i y32[4];
+        for (int half = 0; half < 2; ++half)
+        {
+            __m128i b16 = _mm_cvtepu8_epi16(half ? _mm_srli_si128(b, 8) : b);
+            __m128i g16 = _mm_cvtepu8_epi16(half ? _mm_srli_si128(g, 8) : g);
+            __m128i r16 = _mm_cvtepu8_epi16(half ? _mm_srli_si128(r, 8) : r);
+
+            y32[2 * half] = _mm_srli_epi32(_mm_add_epi32(
+                _mm_madd_epi16(_mm_unpacklo_epi16(b16, g16), bg_weights),
+                _mm_madd_epi16(_mm_unpacklo_epi16(r16, one), r1_weights)), BGR_TO_GREY_SHIFT);
+
+            y32[2 * half + 1] = _mm_srli_epi32(_mm_add_epi32(
+                _mm_madd_epi16(_mm_unpackhi_epi16(b16, g16), bg_weights),
+                _mm_madd_epi16(_mm_unpackhi_epi16(r16, one), r1_weights)), BGR_TO_GREY_SHIFT);
+        }
+
+        if (p_grey)
+        {
+            _mm_storeu_si128((__m128i*)(p_grey + x), _mm_packus_epi16(
+                _mm_packs_epi32(y32[0], y32[1]),
+                _mm_packs_epi32(y32[2], y32[3])));
+        }
+
+        if (p_float)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                _mm_storeu_ps(p_float + x + 4 * i, _mm_mul_ps(_mm_cvtepi32_ps(y32[i]), float_scale));
+            }
+        }
+    }
+
+    return x;
+}
+#endif
+
+
+//------------------------------------------------------------------------------
+inline void bgrToGreyRow(const unsigned char* p_bgr,
+                         unsigned char* p_grey,
+                         float* p_float,
+                         int width)
+//------------------------------------------------------------------------------
+{
+    int x(0);
+    const float scale(1.0f / 255.0f);
+
+#ifdef BGR_TO_GREY_X86
+    int instruction_set(getBgrToGreyInstructionSet());
+    if (instruction_set == 2)
+    {
+        x = bgrToGreyRowAVX2(p_bgr, p_grey, p_float, width);
+    }
+    else if (instruction_set == 1)
+    {
+        x = bgrToGreyRowSSE41(p_bgr, p_grey, p_float, width);
+    }
+#endif
+
+    // Remaining pixels (all of them without SIMD)
+    for (; x < width; ++x)
+    {
+        unsigned char grey(bgrToGreyPixel(p_bgr[3 * x], p_bgr[3 * x + 1], p_bgr[3 * x + 2]));
+
+        if (p_grey)
+        {
+            p_grey[x] = grey;
+        }
+
+        if (p_float)
+        {
+            p_float[x] = grey * scale;
+        }
+    }
+}
+
+
+//-----------------------------------------------------
+inline void bgrToGrey(const cv::Mat& src, cv::Mat& dst)
+//-----------------------------------------------------
+{
+    if (src.type() == CV_8UC1)
+    {
+        src.copyTo(dst);
+        return;
+    }
+
+    if (src.type() != CV_8UC3)
+    {
+        throw std::string("The greyscale conversion only supports 8-bit BGR images.");
+    }
+
+    dst.create(src.size(), CV_8UC1);
+
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range)
+    {
+        for (int y = range.start; y < range.end; ++y)
+        {
+            bgrToGreyRow(src.ptr<unsigned char>(y), dst.ptr<unsigned char>(y), 0, src.cols);
+        }
+    });
+}
+
+
+//----------------------------------------------------------
+inline void bgrToGreyFloat(const cv::Mat& src, cv::Mat& dst)
+//----------------------------------------------------------
+{
+    if (src.type() == CV_8UC1)
+    {
+        src.convertTo(dst, CV_32FC1, 1.0 / 255.0);
+        return;
+    }
+
+    if (src.type() != CV_8UC3)
+    {
+        throw std::string("The greyscale conversion only supports 8-bit BGR images.");
+    }
+
+    dst.create(src.size(), CV_32FC1);
+
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range)
+    {
+        for (int y = range.start; y < range.end; ++y)
+        {
+            bgrToGreyRow(src.ptr<unsigned char>(y), 0, dst.ptr<float>(y), src.cols);
+        }
+    });
+}
+
+
+#endif // BGR_TO_GREY_H
@@ -0,0 +1,412 @@
+/**
+********************************************************************************
+*
+*   @file       bilateralGrid.h
+*
+*   @brief      Fast edge-preserving smoothing of a colour image with a
+*               bilateral grid (Chen, Paris and Durand, "Real-time
+*               edge-aware image processing with the bilateral grid", ACM
+*               SIGGRAPH, 2007), to replace the ten iterations of
+*               cv::bilateralFilter of the cartoon effect (cartoon.h).
+*
+*               The grid is a coarse 3D array over (y, x, grey level). Each
+*               pixel adds its colour and a weight of 1 to the 8 cells
+*               around it (splat), the grid is filtered with [1 2 1] along
+*               the grey levels (blur), then each pixel reads the colour back
+*               from the 8 cells around it, divided by the weight (slice).
+*               Pixels are only averaged with pixels that are close both in
+*               space and in grey level, so the edges are preserved. The
+*               grey level is the guide, as in a joint bilateral filter: the
+*               colour distance of cv::bilateralFilter is approximated by the
+*               grey level distance. The filter of cartoon.h has a very small
+*               colour sigma, so the grid is not filtered along x and y,
+*               which would smooth the texture more than the reference.
+*
+*               The grid is never stored whole: the image is processed in
+*               horizontal bands of cells, with 3 rows of cells that stay in
+*               the cache. The image is split in strips that are processed in
+*               parallel. The quality knob sets the size of the cells: the
+*               higher the quality, the smaller the cells, the closer to the
+*               reference and the slower (see cartoonQualityReport.cxx).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef BILATERAL_GRID_H
+#define BILATERAL_GRID_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::fill, std::min and std::max
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the rows of cells
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "bgrToGrey.h" // SIMD BGR to greyscale conversion
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Highest quality level of the bilateral grid.
+const int BILATERAL_GRID_MAX_QUALITY = 3;
+
+/// Size of the cells in pixels and in grey levels for each quality level.
+const int BILATERAL_GRID_SAMPLING[BILATERAL_GRID_MAX_QUALITY][2] = {{4, 8}, {4, 4}, {3, 4}};
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Bilateral grid of a CV_8UC3 image guided by its grey levels.
+class BilateralGrid
+{
+public:
+    BilateralGrid():
+        m_spatial_sampling(BILATERAL_GRID_SAMPLING[0][0]),
+        m_range_sampling(BILATERAL_GRID_SAMPLING[0][1]),
+        m_width(0),
+        m_depth(0),
+        m_allocation_count(0)
+    {}
+
+    /// Quality from 1 (fastest) to BILATERAL_GRID_MAX_QUALITY.
+    void setQuality(int quality);
+
+    /// Size of the cells in pixels and in grey levels.
+    void setSampling(int spatial_sampling, int range_sampling);
+
+    /// Edge-preserving smoothing of a CV_8UC3 image. The image and the
+    /// result must be different.
+    void apply(const cv::Mat& image, cv::Mat& smoothed);
+
+    /// Number of times apply() had to allocate one of its own buffers. The
+    /// buffers are vectors, so an allocation is a change of capacity.
+    int getAllocationCount() const { return m_allocation_count; }
+
+private:
+    /// Floats per cell: blue, green, red and weight.
+    enum { CELL_SIZE = 4 };
+
+    /// Smooth the pixels of the bands of cells [first_band, last_band),
+    /// using 3 rows of cells at p_rows.
+    void processBands(const cv::Mat& image,
+                      cv::Mat& smoothed,
+                      int first_band,
+                      int last_band,
+                      float* p_rows) const;
+
+    /// Add the pixels of a band to the row of cells above them and to the
+    /// row below. Either row may be 0, if it is not needed.
+    void splatBand(const cv::Mat& image, int band, float* p_top_row, float* p_bottom_row) const;
+
+    /// [1 2 1] / 4 filter of a row of cells along the grey levels.
+    void blurRow(float* p_row) const;
+
+    /// Read the smoothed colour of the pixels of a band.
+    void sliceBand(cv::Mat& smoothed, int band, const float* p_top_row, const float* p_bottom_row) const;
+
+    size_t getRowSize() const { return size_t(m_width) * m_depth * CELL_SIZE; }
+
+    /// Resize a buffer, and count it if its memory has been reallocated.
+    template<typename T> void resizeBuffer(std::vector<T>& buffer, size_t size);
+
+    int m_spatial_sampling;
+    int m_range_sampling;
+
+    /// Size of a row of cells
+    int m_width;
+    int m_depth;
+
+    /// Cell on the left of each column of pixels, and weight of the cell on
+    /// the right
+    std::vector<int> m_cell_x;
+    std::vector<float> m_weight_x;
+
+    /// 3 rows of cells per strip
+    std::vector<float> m_rows;
+
+    /// Grey levels of the image, and an image header on them
+    std::vector<unsigned char> m_guide_pixels;
+    cv::Mat m_guide;
+
+    int m_allocation_count;
+};
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//------------------------------------------------
+inline void BilateralGrid::setQuality(int quality)
+//------------------------------------------------
+{
+    if (quality < 1 || quality > BILATERAL_GRID_MAX_QUALITY)
+    {
+        throw std::string("BilateralGrid: the quality must be between 1 and 3.");
+    }
+
+    setSampling(BILATERAL_GRID_SAMPLING[quality - 1][0], BILATERAL_GRID_SAMPLING[quality - 1][1]);
+}
+
+
+//------------------------------------------------------------------------------
+inline void BilateralGrid::setSampling(int spatial_sampling, int range_sampling)
+//------------------------------------------------------------------------------
+{
+    if (spatial_sampling < 1 || range_sampling < 1)
+    {
+        throw std::string("BilateralGrid: the size of the cells must be positive.");
+    }
+
+    m_spatial_sampling = spatial_sampling;
+    m_range_sampling = range_sampling;
+}
+
+
+//-----------------------------------------------------------------------
+inline void BilateralGrid::apply(const cv::Mat& image, cv::Mat& smoothed)
+//-----------------------------------------------------------------------
+{
+    if (image.type() != CV_8UC3)
+    {
+        throw std::string("BilateralGrid only supports CV_8UC3 images.");
+    }
+
+    // The memory is only allocated when the image grows. The guide is
+    // kept in a vector, so that cv::Mat does not allocate it again when
+    // the size of the image changes.
+    resizeBuffer(m_guide_pixels, image.total());
+    m_guide = cv::Mat(image.size(), CV_8UC1, m_guide_pixels.data());
+    bgrToGrey(image, m_guide);
+    smoothed.create(image.size(), CV_8UC3);
+
+    // A cell on the right of the last pixel and above the highest grey level
+    m_width = (image.cols - 1) / m_spatial_sampling + 2;
+    m_depth = 255 / m_range_sampling + 2;
+
+    resizeBuffer(m_cell_x, image.cols);
+    resizeBuffer(m_weight_x, image.cols);
+    for (int x = 0; x < image.cols; ++x)
+    {
+        m_cell_x[x] = x / m_spatial_sampling;
+        m_weight_x[x] = float(x - m_cell_x[x] * m_spatial_sampling) / m_spatial_sampling;
+    }
+
+    int band_count((image.rows - 1) / m_spatial_sampling + 1);
+    int strip_count(std::max(1, std::min(cv::getNumThreads(), band_count)));
+    resizeBuffer(m_rows, 3 * getRowSize() * strip_count);
+
+    cv::parallel_for_(cv::Range(0, strip_count), [&](const cv::Range& range)
+    {
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            processBands(image,
+                         smoothed,
+                         band_count * strip / strip_count,
+                         band_count * (strip + 1) / strip_count,
+                         &m_rows[3 * getRowSize() * strip]);
+        }
+    });
+}
+
+
+//----------------------------------------------------------------------------------------
+template<typename T> void BilateralGrid::resizeBuffer(std::vector<T>& buffer, size_t size)
+//----------------------------------------------------------------------------------------
+{
+    size_t previous_capacity(buffer.capacity());
+    buffer.resize(size);
+    m_allocation_count += (buffer.capacity() != previous_capacity);
+}
+
+
+//---------------------------------------------------------------
+inline void BilateralGrid::processBands(const cv::Mat& image,
+                                        cv::Mat& smoothed,
+                                        int first_band,
+                                        int last_band,
+                                        float* p_rows) const
+//---------------------------------------------------------------
+{
+    size_t row_size(getRowSize());
+    std::fill(p_rows, p_rows + 3 * row_size, 0.0f);
+
+    // Row of cells c is in slot c % 3. It receives the bands c - 1 and c,
+    // and it is needed to slice them.
+    if (first_band > 0)
+    {
+        splatBand(image, first_band - 1, 0, p_rows + (first_band % 3) * row_size);
+    }
+
+    for (int band = first_band; band <= last_band; ++band)
+    {
+        float* p_top_row(p_rows + (band % 3) * row_size);
+        float* p_bottom_row(band < last_band ? p_rows + ((band + 1) % 3) * row_size : 0);
+
+        // After this band, the row above it is complete
+        splatBand(image, band, p_top_row, p_bottom_row);
+        blurRow(p_top_row);
+
+        // The band above can be sliced, then its top row is reused
+        if (band > first_band)
+        {
+            float* p_previous_row(p_rows + ((band - 1) % 3) * row_size);
+            sliceBand(smoothed, band - 1, p_previous_row, p_top_row);
+            std::fill(p_previous_row, p_previous_row + row_size, 0.0f);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void BilateralGrid::splatBand(const cv::Mat& image,
+                                     int band,
+                                     float* p_top_row,
+                                     float* p_bottom_row) const
+//------------------------------------------------------------------------------
+{
+    size_t x_stride(size_t(m_depth) * CELL_SIZE);
+    float range_scale(1.0f / m_range_sampling);
+    int first_row(band * m_spatial_sampling);
+    int last_row(std::min(image.rows, first_row + m_spatial_sampling));
+
+    for (int y = first_row; y < last_row; ++y)
+    {
+        const unsigned char* p_bgr(image.ptr<unsigned char>(y));
+        const unsigned char* p_grey(m_guide.ptr<unsigned char>(y));
+        float weight_y(float(y - first_row) / m_spatial_sampling);
+
+        // Once for the row of cells above the pixels, once for the row below
+        for (int dy = 0; dy < 2; ++dy)
+        {
+            float* p_row(dy ? p_bottom_row : p_top_row);
+            if (!p_row)
+            {
+                continue;
+            }
+
+            float wy(dy ? weight_y : 1.0f - weight_y);
+            const unsigned char* p_pixel(p_bgr);
+            for (int x = 0; x < image.cols; ++x, p_pixel += 3)
+            {
+                float grid_z(p_grey[x] * range_scale);
+                int cell_z(static_cast<int>(grid_z));
+                float weight_z(grid_z - cell_z);
+                float weight_x(m_weight_x[x]);
+
+                // Bilinear weights of the 4 cells around the pixel in the row
+                float w00(wy * (1.0f - weight_x) * (1.0f - weight_z));
+                float w01(wy * (1.0f - weight_x) * weight_z);
+                float w10(wy * weight_x * (1.0f - weight_z));
+                float w11(wy * weight_x * weight_z);
+
+                float value[CELL_SIZE] = {float(p_pixel[0]), float(p_pixel[1]), float(p_pixel[2]), 1.0f};
+                float* p_cell(p_row + m_cell_x[x] * x_stride + cell_z * CELL_SIZE);
+
+                for (int c = 0; c < CELL_SIZE; ++c)
+                {
+                    p_cell[c] += w00 * value[c];
+                    p_cell[CELL_SIZE + c] += w01 * value[c];
+                    p_cell[x_stride + c] += w10 * value[c];
+                    p_cell[x_stride + CELL_SIZE + c] += w11 * value[c];
+                }
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------
+inline void BilateralGrid::blurRow(float* p_row) const
+//----------------------------------------------------
+{
+    for (int x = 0; x < m_width; ++x)
+    {
+        float previous[CELL_SIZE] = {0.0f, 0.0f, 0.0f, 0.0f};
+        float* p_cell(p_row + size_t(x) * m_depth * CELL_SIZE);
+
+        // The cells below the lowest and above the highest grey level are 0
+        for (int z = 0; z < m_depth; ++z, p_cell += CELL_SIZE)
+        {
+            for (int c = 0; c < CELL_SIZE; ++c)
+            {
+                float current(p_cell[c]);
+                float next(z + 1 < m_depth ? p_cell[CELL_SIZE + c] : 0.0f);
+                p_cell[c] = 0.25f * (previous[c] + next) + 0.5f * current;
+                previous[c] = current;
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void BilateralGrid::sliceBand(cv::Mat& smoothed,
+                                     int band,
+                                     const float* p_top_row,
+                                     const float* p_bottom_row) const
+//------------------------------------------------------------------------------
+{
+    size_t x_stride(size_t(m_depth) * CELL_SIZE);
+    float range_scale(1.0f / m_range_sampling);
+    int first_row(band * m_spatial_sampling);
+    int last_row(std::min(smoothed.rows, first_row + m_spatial_sampling));
+
+    for (int y = first_row; y < last_row; ++y)
+    {
+        const unsigned char* p_grey(m_guide.ptr<unsigned char>(y));
+        unsigned char* p_bgr(smoothed.ptr<unsigned char>(y));
+        float weight_y(float(y - first_row) / m_spatial_sampling);
+
+        for (int x = 0; x < smoothed.cols; ++x, p_bgr += 3)
+        {
+            float grid_z(p_grey[x] * range_scale);
+            int cell_z(static_cast<int>(grid_z));
+            float weight_z(grid_z - cell_z);
+            float weight_x(m_weight_x[x]);
+            size_t offset(m_cell_x[x] * x_stride + cell_z * CELL_SIZE);
+
+            float w00((1.0f - weight_x) * (1.0f - weight_z));
+            float w01((1.0f - weight_x) * weight_z);
+            float w10(weight_x * (1.0f - weight_z));
+            float w11(weight_x * weight_z);
+
+            // Bilinear interpolation in each row of cells, then along y
+            const float* p_top_cell(p_top_row + offset);
+            const float* p_bottom_cell(p_bottom_row + offset);
+            float sum[CELL_SIZE];
+            for (int c = 0; c < CELL_SIZE; ++c)
+            {
+                float top(w00 * p_top_cell[c] + w01 * p_top_cell[CELL_SIZE + c] +
+                          w10 * p_top_cell[x_stride + c] + w11 * p_top_cell[x_stride + CELL_SIZE + c]);
+                float bottom(w00 * p_bottom_cell[c] + w01 * p_bottom_cell[CELL_SIZE + c] +
+                             w10 * p_bottom_cell[x_stride + c] + w11 * p_bottom_cell[x_stride + CELL_SIZE + c]);
+                sum[c] = top + weight_y * (bottom - top);
+            }
+
+            // The pixel itself is in these cells, so the weight is not 0
+            float scale(1.0f / std::max(sum[3], 1.0e-6f));
+            p_bgr[0] = cv::saturate_cast<unsigned char>(sum[0] * scale);
+            p_bgr[1] = cv::saturate_cast<unsigned char>(sum[1] * scale);
+            p_bgr[2] = cv::saturate_cast<unsigned char>(sum[2] * scale);
+        }
+    }
+}
+
+
+#endif // BILATERAL_GRID_H
@@ -0,0 +1,278 @@
+/**
+********************************************************************************
+*
+*   @file       cartoon.h
+*
+*   @brief      Cartoon effect of Lab-09: the colours are flattened with
+*               bilateral filters on a reduced copy of the image, and the
+*               edges found with a Laplacian filter are drawn in black.
+*               The colours are flattened either with ten iterations of the
+*               bilateral filter (the reference), or in a single pass with a
+*               bilateral grid (bilateralGrid.h), which is several times
+*               faster for a similar look. The buffers are kept in a
+*               CartoonContext, so that a video does not allocate them again
+*               for every frame.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef CARTOON_H
+#define CARTOON_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min and std::max
+#include <cassert>   // Header for assert
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "bgrToGrey.h"            // SIMD BGR to greyscale conversion
+#include "bilateralGrid.h"        // Fast edge-preserving smoothing
+#include "cartoonFilters.h"       // Laplacian that does not allocate memory
+#include "constantTimeMedian.h"   // Median filter with reusable histograms
+#include "matAllocationCounter.h" // Count the images allocated by cv::Mat
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Buffers of the cartoon effect, kept from one frame to the next. Use one
+/// context per video stream and per thread: once the first frame has been
+/// processed, the frames of the same size reuse the buffers, instead of
+/// allocating about twenty images per frame. In debug builds (NDEBUG not
+/// defined) the context installs MatAllocationCounter, so every image
+/// allocated while a frame is processed is counted, the temporary images of
+/// the OpenCV functions included, and an assertion checks that there is
+/// none when the frame has the same size as the previous one. The buffers
+/// of the bilateral grid are counted too. Two kinds of images are left out:
+/// the bordered copy that cv::bilateralFilter makes of its input at every
+/// call, which is scratch memory of OpenCV, and the cartoon, which belongs
+/// to the caller, e.g. a frame of the pool of videoFromFile.
+class CartoonContext
+{
+public:
+    /// grid_quality 0 is the reference, ten iterations of the bilateral
+    /// filter, and 1 to BILATERAL_GRID_MAX_QUALITY use a bilateral grid,
+    /// from the fastest to the closest to the reference.
+    explicit CartoonContext(int grid_quality = 0);
+
+    void setGridQuality(int grid_quality);
+    int getGridQuality() const { return m_grid_quality; }
+
+    /// Cartoon version of a CV_8UC3 BGR frame. cartoon may be frame.
+    void apply(const cv::Mat& frame, cv::Mat& cartoon);
+
+    /// Flatten the colours of the reduced frame. The result is a buffer of
+    /// the context, valid until the next call.
+    const cv::Mat& smoothColours(const cv::Mat& small_frame);
+
+    /// Number of frames processed.
+    long getFrameCount() const { return m_frame_count; }
+
+    /// Number of buffers (re)allocated while processing the last frame, and
+    /// since the first frame, the first frame excluded. The images are only
+    /// counted once MatAllocationCounter has been installed, and the scratch
+    /// images of cv::bilateralFilter are not counted.
+    int getLastAllocationCount() const { return m_last_allocation_count; }
+    long getSteadyAllocationCount() const { return m_steady_allocation_count; }
+
+private:
+    int m_grid_quality;
+    BilateralGrid m_bilateral_grid;
+    ConstantTimeMedianBuffers m_median_buffers;
+
+    cv::Mat m_greyscale_frame;
+    cv::Mat m_median_frame;
+    cv::Mat m_edge_frame;
+    cv::Mat m_small_frame;
+
+    /// The bilateral filters go back and forth between these two buffers
+    cv::Mat m_bilateral_frames[2];
+
+    cv::Mat m_grid_frame;
+    cv::Mat m_output_frame;
+
+    long m_frame_count;
+    cv::Size m_previous_size;
+    int m_last_allocation_count;
+    long m_steady_allocation_count;
+
+    /// Images allocated inside cv::bilateralFilter, since the first frame
+    long m_scratch_allocation_count;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Cartoon version of a CV_8UC3 BGR frame, see CartoonContext for
+/// grid_quality. The buffers are allocated for this frame only: use a
+/// CartoonContext for a video.
+inline void cartooniseFrame(const cv::Mat& frame, cv::Mat& cartoon, int grid_quality = 0);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//------------------------------------------------------
+inline CartoonContext::CartoonContext(int grid_quality):
+//------------------------------------------------------
+    m_grid_quality(0),
+    m_frame_count(0),
+    m_last_allocation_count(0),
+    m_steady_allocation_count(0),
+    m_scratch_allocation_count(0)
+{
+    setGridQuality(grid_quality);
+
+#ifndef NDEBUG
+    MatAllocationCounter::install();
+#endif
+}
+
+
+//----------------------------------------------------------
+inline void CartoonContext::setGridQuality(int grid_quality)
+//----------------------------------------------------------
+{
+    if (grid_quality < 0 || grid_quality > BILATERAL_GRID_MAX_QUALITY)
+    {
+        throw std::string("CartoonContext: the grid quality must be between 0 and 3.");
+    }
+
+    if (grid_quality > 0)
+    {
+        m_bilateral_grid.setQuality(grid_quality);
+    }
+    m_grid_quality = grid_quality;
+
+    // The grid may need larger buffers, the next frame is not steady
+    m_previous_size = cv::Size();
+}
+
+
+//-----------------------------------------------------------------------
+inline void CartoonContext::apply(const cv::Mat& frame, cv::Mat& cartoon)
+//-----------------------------------------------------------------------
+{
+    long previous_image_count(MatAllocationCounter::getThreadCount());
+    long previous_scratch_count(m_scratch_allocation_count);
+    int previous_grid_allocation_count(m_bilateral_grid.getAllocationCount());
+
+    // Convert the frame to greyscale
+    bgrToGrey(frame, m_greyscale_frame);
+
+    // Apply a median filter with a size of 7 pixels (radius 3)
+    constantTimeMedianBlur(m_greyscale_frame, m_median_frame, 3, m_median_buffers);
+
+    // Perform a 5x5 Laplacian filter, the output is unsigned char
+    laplacian5x5(m_median_frame, m_edge_frame);
+
+    // Reduce the frame size by a factor 4 using pixel area relation
+    double ds_factor(4);
+    cv::resize(frame, m_small_frame, cv::Size(0, 0), 1.0 / ds_factor, 1.0 / ds_factor, cv::INTER_AREA);
+
+    // Flatten the colours
+    const cv::Mat& smoothed_frame(smoothColours(m_small_frame));
+
+    // Restore the size of the frame using bi-linear interpolation. The size
+    // is given explicitly in case it is not a multiple of ds_factor
+    cv::resize(smoothed_frame, m_output_frame, frame.size(), 0, 0, cv::INTER_LINEAR);
+
+    // Count the buffers allocated, before the cartoon of the caller
+    m_last_allocation_count = int(MatAllocationCounter::getThreadCount() - previous_image_count -
+        (m_scratch_allocation_count - previous_scratch_count)) +
+        m_bilateral_grid.getAllocationCount() - previous_grid_allocation_count;
+
+    // Add a thick boundary: the pixels where the Laplacian is above 100 are
+    // black, as a THRESH_BINARY_INV mask and a boolean operator (and). The
+    // frame has been read, so cartoon may be frame.
+    cartoon.create(frame.size(), frame.type());
+    int strip_count(std::max(1, std::min(cv::getNumThreads(), frame.rows)));
+    cv::parallel_for_(cv::Range(0, strip_count), [&](const cv::Range& range)
+    {
+        for (int y = frame.rows * range.start / strip_count; y < frame.rows * range.end / strip_count; ++y)
+        {
+            const unsigned char* p_colour(m_output_frame.ptr<unsigned char>(y));
+            const unsigned char* p_edge(m_edge_frame.ptr<unsigned char>(y));
+            unsigned char* p_cartoon(cartoon.ptr<unsigned char>(y));
+
+            for (int x = 0; x < frame.cols; ++x)
+            {
+                unsigned char mask(p_edge[x] > 100 ? 0 : 255);
+                p_cartoon[3 * x] = p_colour[3 * x] & mask;
+                p_cartoon[3 * x + 1] = p_colour[3 * x + 1] & mask;
+                p_cartoon[3 * x + 2] = p_colour[3 * x + 2] & mask;
+            }
+        }
+    });
+
+    // Steady state: no allocation unless the size of the frames changes
+    bool same_size(m_frame_count > 0 && frame.size() == m_previous_size);
+    assert(!same_size || m_last_allocation_count == 0);
+
+    if (m_frame_count > 0)
+    {
+        m_steady_allocation_count += m_last_allocation_count;
+    }
+    m_previous_size = frame.size();
+    ++m_frame_count;
+}
+
+
+//-----------------------------------------------------------------------------
+inline const cv::Mat& CartoonContext::smoothColours(const cv::Mat& small_frame)
+//-----------------------------------------------------------------------------
+{
+    if (m_grid_quality > 0)
+    {
+        m_bilateral_grid.apply(small_frame, m_grid_frame);
+        return m_grid_frame;
+    }
+
+    // Apply a bilateral filter 10 times. The kernel size is 5, sigma colour
+    // is 5, and sigma space is 7. The filter cannot work in place, so
+    // iteration i reads buffer i % 2 and writes the other one.
+    for (int i = 0; i < 2; ++i)
+    {
+        m_bilateral_frames[i].create(small_frame.size(), CV_8UC3);
+    }
+    small_frame.copyTo(m_bilateral_frames[0]);
+
+    // The output buffers are allocated, what is allocated now is the
+    // scratch memory of cv::bilateralFilter
+    long previous_image_count(MatAllocationCounter::getThreadCount());
+    for (int i = 0; i < 10; ++i)
+    {
+        cv::bilateralFilter(m_bilateral_frames[i % 2], m_bilateral_frames[(i + 1) % 2], 5, 5, 7);
+    }
+    m_scratch_allocation_count += MatAllocationCounter::getThreadCount() - previous_image_count;
+
+    return m_bilateral_frames[0];
+}
+
+
+//-----------------------------------------------------------------------------------
+inline void cartooniseFrame(const cv::Mat& frame, cv::Mat& cartoon, int grid_quality)
+//-----------------------------------------------------------------------------------
+{
+    CartoonContext context(grid_quality);
+    context.apply(frame, cartoon);
+}
+
+
+#endif // CARTOON_H
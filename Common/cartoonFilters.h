@@ -0,0 +1,117 @@
+/**
+********************************************************************************
+*
+*   @file       cartoonFilters.h
+*
+*   @brief      The 5x5 Laplacian of the cartoon effect (cartoon.h), written
+*               so that it never allocates memory: it only writes into the
+*               image of the caller, which is reused from one frame to the
+*               next, whereas cv::Laplacian allocates a bordered copy and
+*               its kernels every time it is called. The result is the same
+*               as cv::Laplacian with an 8-bit output.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef CARTOON_FILTERS_H
+#define CARTOON_FILTERS_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min and std::max
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Number of pixels of a row processed at once by the Laplacian.
+const int CARTOON_FILTER_BLOCK_SIZE = 256;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// cv::Laplacian(src, dst, CV_8U, 5) of a CV_8UC1 image. src and dst must
+/// be different.
+inline void laplacian5x5(const cv::Mat& src, cv::Mat& dst);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//--------------------------------------------------------
+inline void laplacian5x5(const cv::Mat& src, cv::Mat& dst)
+//--------------------------------------------------------
+{
+    if (src.type() != CV_8UC1 || src.data == dst.data)
+    {
+        throw std::string("laplacian5x5: the input must be a CV_8UC1 image, different from the output.");
+    }
+
+    dst.create(src.size(), CV_8UC1);
+
+    int strip_count(std::max(1, std::min(cv::getNumThreads(), src.rows)));
+    cv::parallel_for_(cv::Range(0, strip_count), [&](const cv::Range& range)
+    {
+        // Second derivative [1 0 -2 0 1] along one axis, smoothing
+        // [1 4 6 4 1] along the other, as cv::getDerivKernels. Vertical sums
+        // of a block of columns with 2 more columns on each side.
+        int smoothed_sum[CARTOON_FILTER_BLOCK_SIZE + 4];
+        int derivative_sum[CARTOON_FILTER_BLOCK_SIZE + 4];
+
+        for (int y = src.rows * range.start / strip_count; y < src.rows * range.end / strip_count; ++y)
+        {
+            const unsigned char* p_row[5];
+            for (int i = 0; i < 5; ++i)
+            {
+                p_row[i] = src.ptr<unsigned char>(cv::borderInterpolate(y + i - 2, src.rows, cv::BORDER_REFLECT_101));
+            }
+
+            unsigned char* p_output(dst.ptr<unsigned char>(y));
+            for (int first_x = 0; first_x < src.cols; first_x += CARTOON_FILTER_BLOCK_SIZE)
+            {
+                int block_size(std::min(int(CARTOON_FILTER_BLOCK_SIZE), src.cols - first_x));
+
+                for (int i = 0; i < block_size + 4; ++i)
+                {
+                    int x(first_x + i - 2);
+                    if (x < 0 || x >= src.cols)
+                    {
+                        x = cv::borderInterpolate(x, src.cols, cv::BORDER_REFLECT_101);
+                    }
+
+                    int p0(p_row[0][x]), p1(p_row[1][x]), p2(p_row[2][x]), p3(p_row[3][x]), p4(p_row[4][x]);
+                    smoothed_sum[i] = p0 + 4 * (p1 + p3) + 6 * p2 + p4;
+                    derivative_sum[i] = p0 - 2 * p2 + p4;
+                }
+
+                for (int i = 0; i < block_size; ++i)
+                {
+                    int value(smoothed_sum[i] - 2 * smoothed_sum[i + 2] + smoothed_sum[i + 4] +
+                              derivative_sum[i] + 4 * (derivative_sum[i + 1] + derivative_sum[i + 3]) +
+                              6 * derivative_sum[i + 2] + derivative_sum[i + 4]);
+                    p_output[first_x + i] = cv::saturate_cast<unsigned char>(value);
+                }
+            }
+        }
+    });
+}
+
+
+#endif // CARTOON_FILTERS_H
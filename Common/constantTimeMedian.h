@@ -0,0 +1,351 @@
+/**
+********************************************************************************
+*
+*   @file       constantTimeMedian.h
+*
+*   @brief      A median filter whose cost per pixel does not depend on the
+*               radius of the kernel. It implements the histogram-based
+*               algorithm of Perreault and Hebert ("Median Filtering in
+*               Constant Time", IEEE TIP, 2007): one histogram per column,
+*               a kernel histogram slid along the row, and a two-level
+*               (coarse/fine) histogram so that only the bins that are
+*               needed are updated. The image is split in horizontal strips
+*               that are processed in parallel. The column histograms can be
+*               kept in a ConstantTimeMedianBuffers from one call to the
+*               next, e.g. for the frames of a video.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef CONSTANT_TIME_MEDIAN_H
+#define CONSTANT_TIME_MEDIAN_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min and std::max
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the histograms
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Column histograms of the strips, for one type of counter.
+template<typename CountType>
+struct ConstantTimeMedianHistograms
+{
+    /// One fine (256 bins) histogram per column and channel, for each strip
+    std::vector<std::vector<CountType> > fine_set;
+
+    /// One coarse (16 bins) histogram per column and channel, for each strip
+    std::vector<std::vector<CountType> > coarse_set;
+};
+
+
+/// Histograms of constantTimeMedianBlur. Pass the same buffers to every
+/// call so that the histograms are only allocated when the image grows.
+struct ConstantTimeMedianBuffers
+{
+    /// Histograms of the kernels of up to 255x255 pixels
+    ConstantTimeMedianHistograms<unsigned short> short_histograms;
+
+    /// Histograms of the larger kernels
+    ConstantTimeMedianHistograms<unsigned int> int_histograms;
+};
+
+
+/// Filter a strip of rows. CountType must be able to hold (2r+1)^2.
+template<typename CountType>
+class ConstantTimeMedianBody : public cv::ParallelLoopBody
+{
+public:
+    ConstantTimeMedianBody(const cv::Mat& src,
+                           cv::Mat& dst,
+                           int radius,
+                           int strip_count,
+                           ConstantTimeMedianHistograms<CountType>& histograms):
+        m_src(src),
+        m_dst(dst),
+        m_radius(radius),
+        m_strip_count(strip_count),
+        m_histograms(histograms)
+    {
+        // Each strip only touches its own histograms
+        m_histograms.fine_set.resize(strip_count);
+        m_histograms.coarse_set.resize(strip_count);
+    }
+
+    virtual void operator()(const cv::Range& range) const
+    {
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            processStrip(strip);
+        }
+    }
+
+private:
+    void processStrip(int strip) const;
+
+    void processRow(const std::vector<CountType>& column_fine,
+                    const std::vector<CountType>& column_coarse,
+                    int channel,
+                    unsigned char* output) const;
+
+    int clampColumn(int x) const
+    {
+        return std::max(0, std::min(x, m_src.cols - 1));
+    }
+
+    int clampRow(int y) const
+    {
+        return std::max(0, std::min(y, m_src.rows - 1));
+    }
+
+    const cv::Mat& m_src;
+    cv::Mat& m_dst;
+    int m_radius;
+    int m_strip_count;
+    ConstantTimeMedianHistograms<CountType>& m_histograms;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Median filter of a CV_8U image (any number of channels) using a square
+/// kernel of size 2 * radius + 1. The border is replicated, as in
+/// cv::medianBlur, so that both give the same result.
+inline void constantTimeMedianBlur(const cv::Mat& src, cv::Mat& dst, int radius);
+
+/// Same as above, the histograms are kept in buffers.
+inline void constantTimeMedianBlur(const cv::Mat& src,
+                                   cv::Mat& dst,
+                                   int radius,
+                                   ConstantTimeMedianBuffers& buffers);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//------------------------------------------------------------------------------
+inline void constantTimeMedianBlur(const cv::Mat& src, cv::Mat& dst, int radius)
+//------------------------------------------------------------------------------
+{
+    ConstantTimeMedianBuffers buffers;
+    constantTimeMedianBlur(src, dst, radius, buffers);
+}
+
+
+//-------------------------------------------------------------------
+inline void constantTimeMedianBlur(const cv::Mat& src,
+                                   cv::Mat& dst,
+                                   int radius,
+                                   ConstantTimeMedianBuffers& buffers)
+//-------------------------------------------------------------------
+{
+    if (src.depth() != CV_8U)
+    {
+        throw std::string("The constant-time median filter only supports 8-bit images.");
+    }
+
+    if (radius < 0)
+    {
+        throw std::string("The radius of the median filter cannot be negative.");
+    }
+
+    // Nothing to filter
+    if (radius == 0 || src.empty())
+    {
+        src.copyTo(dst);
+        return;
+    }
+
+    // Filtering in place is not possible
+    cv::Mat input = src;
+    if (src.data == dst.data)
+    {
+        input = src.clone();
+    }
+    dst.create(src.size(), src.type());
+
+    // One strip per thread, each strip has its own column histograms
+    int strip_count(std::max(1, std::min(cv::getNumThreads(), input.rows)));
+
+    // Use 16-bit counters whenever the kernel is small enough
+    if ((2 * radius + 1) * (2 * radius + 1) <= 0xFFFF)
+    {
+        cv::parallel_for_(cv::Range(0, strip_count),
+            ConstantTimeMedianBody<unsigned short>(input, dst, radius, strip_count, buffers.short_histograms));
+    }
+    else
+    {
+        cv::parallel_for_(cv::Range(0, strip_count),
+            ConstantTimeMedianBody<unsigned int>(input, dst, radius, strip_count, buffers.int_histograms));
+    }
+}
+
+
+//--------------------------------------------------------------------
+template<typename CountType>
+void ConstantTimeMedianBody<CountType>::processStrip(int strip) const
+//--------------------------------------------------------------------
+{
+    int first_row(m_src.rows * strip / m_strip_count);
+    int last_row(m_src.rows * (strip + 1) / m_strip_count);
+
+    if (first_row >= last_row)
+    {
+        return;
+    }
+
+    // One fine (256 bins) and one coarse (16 bins) histogram per column and
+    // channel. assign() keeps the memory of the previous call.
+    std::size_t column_count(std::size_t(m_src.cols) * m_src.channels());
+    std::vector<CountType>& column_fine(m_histograms.fine_set[strip]);
+    std::vector<CountType>& column_coarse(m_histograms.coarse_set[strip]);
+    column_fine.assign(column_count * 256, 0);
+    column_coarse.assign(column_count * 16, 0);
+
+    // Add (or remove) a row of the image to the column histograms
+    auto updateColumns = [&](int y, CountType delta)
+    {
+        const unsigned char* p_input = m_src.ptr<unsigned char>(clampRow(y));
+        for (std::size_t i = 0; i < column_count; ++i)
+        {
+            column_fine[i * 256 + p_input[i]] += delta;
+            column_coarse[i * 16 + (p_input[i] >> 4)] += delta;
+        }
+    };
+
+    // Initialise the column histograms for the first row of the strip
+    for (int dy = -m_radius; dy <= m_radius; ++dy)
+    {
+        updateColumns(first_row + dy, CountType(1));
+    }
+
+    for (int y = first_row; y < last_row; ++y)
+    {
+        // Slide the column histograms down by one row
+        if (y > first_row)
+        {
+            updateColumns(y - m_radius - 1, CountType(-1));
+            updateColumns(y + m_radius, CountType(1));
+        }
+
+        unsigned char* p_output = m_dst.ptr<unsigned char>(y);
+        for (int channel = 0; channel < m_src.channels(); ++channel)
+        {
+            processRow(column_fine, column_coarse, channel, p_output);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------
+template<typename CountType>
+void ConstantTimeMedianBody<CountType>::processRow(const std::vector<CountType>& column_fine,
+                                                   const std::vector<CountType>& column_coarse,
+                                                   int channel,
+                                                   unsigned char* output) const
+//--------------------------------------------------------------------------------
+{
+    int channels(m_src.channels());
+    CountType rank(CountType(((2 * m_radius + 1) * (2 * m_radius + 1)) / 2));
+
+    CountType coarse[16];
+    CountType fine[256];
+
+    // Column at which each segment of the fine histogram was last updated.
+    // The initial value forces a full update the first time it is used.
+    int last_update[16];
+    std::fill(last_update, last_update + 16, -2 * m_radius - 2);
+    std::fill(coarse, coarse + 16, CountType(0));
+
+    // Coarse histogram of the first kernel of the row
+    for (int dx = -m_radius; dx <= m_radius; ++dx)
+    {
+        const CountType* p_column = &column_coarse[(clampColumn(dx) * channels + channel) * 16];
+        for (int bin = 0; bin < 16; ++bin)
+        {
+            coarse[bin] += p_column[bin];
+        }
+    }
+
+    for (int x = 0; x < m_src.cols; ++x)
+    {
+        // Slide the coarse histogram to the right by one column
+        if (x > 0)
+        {
+            const CountType* p_add    = &column_coarse[(clampColumn(x + m_radius)     * channels + channel) * 16];
+            const CountType* p_remove = &column_coarse[(clampColumn(x - m_radius - 1) * channels + channel) * 16];
+            for (int bin = 0; bin < 16; ++bin)
+            {
+                coarse[bin] += p_add[bin] - p_remove[bin];
+            }
+        }
+
+        // Find the coarse bin that contains the median
+        CountType sum(0);
+        int coarse_bin(0);
+        while (coarse_bin < 15 && CountType(sum + coarse[coarse_bin]) <= rank)
+        {
+            sum += coarse[coarse_bin++];
+        }
+
+        // Bring the corresponding segment of the fine histogram up to date
+        CountType* p_fine = fine + coarse_bin * 16;
+        if (x - last_update[coarse_bin] > 2 * m_radius + 1)
+        {
+            // Cheaper to rebuild it from scratch
+            std::fill(p_fine, p_fine + 16, CountType(0));
+            for (int dx = -m_radius; dx <= m_radius; ++dx)
+            {
+                const CountType* p_column = &column_fine[(clampColumn(x + dx) * channels + channel) * 256 + coarse_bin * 16];
+                for (int bin = 0; bin < 16; ++bin)
+                {
+                    p_fine[bin] += p_column[bin];
+                }
+            }
+        }
+        else
+        {
+            for (int j = last_update[coarse_bin] + 1; j <= x; ++j)
+            {
+                const CountType* p_add    = &column_fine[(clampColumn(j + m_radius)     * channels + channel) * 256 + coarse_bin * 16];
+                const CountType* p_remove = &column_fine[(clampColumn(j - m_radius - 1) * channels + channel) * 256 + coarse_bin * 16];
+                for (int bin = 0; bin < 16; ++bin)
+                {
+                    p_fine[bin] += p_add[bin] - p_remove[bin];
+                }
+            }
+        }
+        last_update[coarse_bin] = x;
+
+        // Find the median within the segment
+        int fine_bin(0);
+        while (fine_bin < 15 && CountType(sum + p_fine[fine_bin]) <= rank)
+        {
+            sum += p_fine[fine_bin++];
+        }
+
+        output[x * channels + channel] = static_cast<unsigned char>(coarse_bin * 16 + fine_bin);
+    }
+}
+
+
+#endif // CONSTANT_TIME_MEDIAN_H
@@ -0,0 +1,456 @@
+/**
+********************************************************************************
+*
+*   @file       edgeMapIO.h
+*
+*   @brief      Compact files for binary edge maps, chosen by the extension:
+*               - .pbm: binary PBM (P4), 1 bit per pixel, 1 (black) for the
+*                 edges;
+*               - .rle: run lengths of each row, alternately background and
+*                 edges, starting with the background, stored as
+*                 variable-length integers (7 bits per byte) after the
+*                 header "EDGE_RLE\n<width> <height>\n";
+*               - .csv: sparse list of the edge pixels, "x,y" or
+*                 "x,y,magnitude,direction" when the gradient is given,
+*                 after a first line "# <width> <height>".
+*               Any other extension is written with cv::imwrite as an 8-bit
+*               image. An edge is a non-zero pixel, and the edge maps read
+*               back are CV_8UC1 images with 255 for the edges.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef EDGE_MAP_IO_H
+#define EDGE_MAP_IO_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::fill
+#include <fstream>   // Header to read and write the files
+#include <sstream>   // Header to parse the CSV lines
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store a packed row
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "precisionPolicy.h" // Units of the magnitude
+#include "stripImageIO.h"    // File extensions and PNM headers
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Write the edges (non-zero pixels of a single-channel image). The
+/// magnitude (CV_32FC1 or CV_16SC1) and the direction (CV_8UC1) of the
+/// gradient are optional and only used by the CSV format, where the
+/// magnitude is written in the units of the float pipeline.
+inline void writeEdgeMap(const std::string& file_name,
+                         const cv::Mat& edges,
+                         const cv::Mat& magnitude = cv::Mat(),
+                         const cv::Mat& direction = cv::Mat());
+
+/// Read an edge map as a CV_8UC1 image (0 or 255). With the CSV format, the
+/// magnitude and the direction of the gradient are returned if they are in
+/// the file and requested (0 elsewhere).
+inline cv::Mat readEdgeMap(const std::string& file_name,
+                           cv::Mat* p_magnitude = 0,
+                           cv::Mat* p_direction = 0);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+inline void writePBMEdgeMap(const std::string& file_name, const cv::Mat& edges)
+//-----------------------------------------------------------------------------
+{
+    std::ofstream output(file_name.c_str(), std::ios::binary);
+    output << "P4\n" << edges.cols << " " << edges.rows << "\n";
+
+    // The rows are padded to a whole number of bytes, first pixel in the
+    // most significant bit
+    std::vector<char> packed_row((edges.cols + 7) / 8);
+    for (int y = 0; y < edges.rows; ++y)
+    {
+        const unsigned char* p_edges = edges.ptr<unsigned char>(y);
+        std::fill(packed_row.begin(), packed_row.end(), 0);
+
+        for (int x = 0; x < edges.cols; ++x)
+        {
+            if (p_edges[x])
+            {
+                packed_row[x >> 3] |= char(0x80 >> (x & 7));
+            }
+        }
+
+        output.write(&packed_row[0], packed_row.size());
+    }
+
+    if (!output)
+    {
+        throw std::string("Could not write the edge map \"") + file_name + "\".";
+    }
+}
+
+
+//---------------------------------------------------------
+inline cv::Mat readPBMEdgeMap(const std::string& file_name)
+//---------------------------------------------------------
+{
+    std::ifstream input(file_name.c_str(), std::ios::binary);
+
+    char magic[2] = {0, 0};
+    input.read(magic, 2);
+    if (!input || magic[0] != 'P' || magic[1] != '4')
+    {
+        throw std::string("Could not open the PBM file \"") + file_name + "\" (only binary PBM is supported).";
+    }
+
+    int width(readPNMHeaderValue(input));
+    int height(readPNMHeaderValue(input));
+    if (!input || width <= 0 || height <= 0)
+    {
+        throw std::string("Invalid PBM header in \"") + file_name + "\".";
+    }
+
+    // A single white space separates the header from the pixels
+    input.get();
+
+    cv::Mat edges(height, width, CV_8UC1);
+    std::vector<char> packed_row((width + 7) / 8);
+    for (int y = 0; y < height; ++y)
+    {
+        input.read(&packed_row[0], packed_row.size());
+        if (!input)
+        {
+            throw std::string("Unexpected end of the PBM file \"") + file_name + "\".";
+        }
+
+        unsigned char* p_edges = edges.ptr<unsigned char>(y);
+        for (int x = 0; x < width; ++x)
+        {
+            p_edges[x] = (packed_row[x >> 3] & (0x80 >> (x & 7))) ? 255 : 0;
+        }
+    }
+
+    return edges;
+}
+
+
+//--------------------------------------------------------------
+inline void writeVariableLength(std::ostream& output, int value)
+//--------------------------------------------------------------
+{
+    // 7 bits per byte, the highest bit is set if more bytes follow
+    while (value >= 0x80)
+    {
+        output.put(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.put(char(value));
+}
+
+
+//------------------------------------------------
+inline int readVariableLength(std::istream& input)
+//------------------------------------------------
+{
+    int value(0);
+    for (int shift = 0; shift < 32; shift += 7)
+    {
+        int c(input.get());
+        if (c == std::char_traits<char>::eof())
+        {
+            return -1;
+        }
+
+        value |= (c & 0x7F) << shift;
+        if (!(c & 0x80))
+        {
+            return value;
+        }
+    }
+
+    return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+inline void writeRLEEdgeMap(const std::string& file_name, const cv::Mat& edges)
+//-----------------------------------------------------------------------------
+{
+    std::ofstream output(file_name.c_str(), std::ios::binary);
+    output << "EDGE_RLE\n" << edges.cols << " " << edges.rows << "\n";
+
+    for (int y = 0; y < edges.rows; ++y)
+    {
+        const unsigned char* p_edges = edges.ptr<unsigned char>(y);
+
+        // Alternate background and edge runs, the first one may be empty
+        bool edge(false);
+        int x(0);
+        while (x < edges.cols)
+        {
+            int start(x);
+            while (x < edges.cols && (p_edges[x] != 0) == edge)
+            {
+                ++x;
+            }
+
+            writeVariableLength(output, x - start);
+            edge = !edge;
+        }
+    }
+
+    if (!output)
+    {
+        throw std::string("Could not write the edge map \"") + file_name + "\".";
+    }
+}
+
+
+//---------------------------------------------------------
+inline cv::Mat readRLEEdgeMap(const std::string& file_name)
+//---------------------------------------------------------
+{
+    std::ifstream input(file_name.c_str(), std::ios::binary);
+
+    std::string magic;
+    int width(0), height(0);
+    input >> magic >> width >> height;
+    if (!input || magic != "EDGE_RLE" || width <= 0 || height <= 0)
+    {
+        throw std::string("Invalid RLE edge map \"") + file_name + "\".";
+    }
+
+    // A single new line separates the header from the runs
+    input.get();
+
+    cv::Mat edges(height, width, CV_8UC1);
+    for (int y = 0; y < height; ++y)
+    {
+        unsigned char* p_edges = edges.ptr<unsigned char>(y);
+
+        bool edge(false);
+        int x(0);
+        while (x < width)
+        {
+            int length(readVariableLength(input));
+            if (length < 0 || x + length > width)
+            {
+                throw std::string("Corrupted RLE edge map \"") + file_name + "\".";
+            }
+
+            std::fill(p_edges + x, p_edges + x + length, edge ? 255 : 0);
+            x += length;
+            edge = !edge;
+        }
+    }
+
+    return edges;
+}
+
+
+//------------------------------------------------------------------------------
+inline void writeCSVEdgeMap(const std::string& file_name,
+                            const cv::Mat& edges,
+                            const cv::Mat& magnitude,
+                            const cv::Mat& direction)
+//------------------------------------------------------------------------------
+{
+    bool gradient(!magnitude.empty() && !direction.empty());
+    if (gradient && ((magnitude.type() != CV_32FC1 && magnitude.type() != CV_16SC1) || direction.type() != CV_8UC1 ||
+        magnitude.size() != edges.size() || direction.size() != edges.size()))
+    {
+        throw std::string("The gradient of the edge map must be a CV_32FC1 or CV_16SC1 magnitude and a CV_8UC1 direction of the same size.");
+    }
+
+    // Fixed-point magnitudes are in grey levels
+    cv::Mat float_magnitude = magnitude;
+    if (gradient && magnitude.type() != CV_32FC1)
+    {
+        magnitude.convertTo(float_magnitude, CV_32FC1, getUnitScale(magnitude));
+    }
+
+    std::ofstream output(file_name.c_str());
+    output << "# " << edges.cols << " " << edges.rows << "\n";
+    output << (gradient ? "x,y,magnitude,direction\n" : "x,y\n");
+    output.precision(9);
+
+    for (int y = 0; y < edges.rows; ++y)
+    {
+        const unsigned char* p_edges = edges.ptr<unsigned char>(y);
+
+        for (int x = 0; x < edges.cols; ++x)
+        {
+            if (p_edges[x])
+            {
+                output << x << "," << y;
+                if (gradient)
+                {
+                    output << "," << float_magnitude.at<float>(y, x) << "," << int(direction.at<unsigned char>(y, x));
+                }
+                output << "\n";
+            }
+        }
+    }
+
+    if (!output)
+    {
+        throw std::string("Could not write the edge map \"") + file_name + "\".";
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline cv::Mat readCSVEdgeMap(const std::string& file_name,
+                              cv::Mat* p_magnitude,
+                              cv::Mat* p_direction)
+//------------------------------------------------------------------------------
+{
+    std::ifstream input(file_name.c_str());
+
+    std::string hash;
+    int width(0), height(0);
+    input >> hash >> width >> height;
+    if (!input || hash != "#" || width <= 0 || height <= 0)
+    {
+        throw std::string("Invalid CSV edge map \"") + file_name + "\".";
+    }
+
+    // Column names
+    std::string line;
+    std::getline(input, line);
+    std::getline(input, line);
+    bool gradient(line.find("magnitude") != std::string::npos);
+
+    cv::Mat edges(height, width, CV_8UC1, cv::Scalar(0));
+    if (p_magnitude)
+    {
+        p_magnitude->create(height, width, CV_32FC1);
+        p_magnitude->setTo(cv::Scalar(0));
+    }
+    if (p_direction)
+    {
+        p_direction->create(height, width, CV_8UC1);
+        p_direction->setTo(cv::Scalar(0));
+    }
+
+    while (std::getline(input, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::stringstream line_stream(line);
+        int x(-1), y(-1), direction(0);
+        float magnitude(0);
+        char comma;
+        line_stream >> x >> comma >> y;
+        if (gradient)
+        {
+            line_stream >> comma >> magnitude >> comma >> direction;
+        }
+
+        if (!line_stream || x < 0 || x >= width || y < 0 || y >= height)
+        {
+            throw std::string("Invalid line \"") + line + "\" in the CSV edge map \"" + file_name + "\".";
+        }
+
+        edges.at<unsigned char>(y, x) = 255;
+        if (p_magnitude)
+        {
+            p_magnitude->at<float>(y, x) = magnitude;
+        }
+        if (p_direction)
+        {
+            p_direction->at<unsigned char>(y, x) = (unsigned char)(direction);
+        }
+    }
+
+    return edges;
+}
+
+
+//------------------------------------------------------------------------------
+inline void writeEdgeMap(const std::string& file_name,
+                         const cv::Mat& edges,
+                         const cv::Mat& magnitude,
+                         const cv::Mat& direction)
+//------------------------------------------------------------------------------
+{
+    if (edges.channels() != 1)
+    {
+        throw std::string("An edge map must have a single channel.");
+    }
+
+    // 255 for the edges, whatever the type of the input
+    cv::Mat binary_edges;
+    cv::compare(edges, 0.0, binary_edges, cv::CMP_NE);
+
+    std::string extension(getLowerCaseExtension(file_name));
+    if (extension == "pbm")
+    {
+        writePBMEdgeMap(file_name, binary_edges);
+    }
+    else if (extension == "rle")
+    {
+        writeRLEEdgeMap(file_name, binary_edges);
+    }
+    else if (extension == "csv")
+    {
+        writeCSVEdgeMap(file_name, binary_edges, magnitude, direction);
+    }
+    else if (!cv::imwrite(file_name, binary_edges))
+    {
+        throw std::string("Could not write the edge map \"") + file_name + "\".";
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline cv::Mat readEdgeMap(const std::string& file_name,
+                           cv::Mat* p_magnitude,
+                           cv::Mat* p_direction)
+//------------------------------------------------------------------------------
+{
+    std::string extension(getLowerCaseExtension(file_name));
+    if (extension == "pbm")
+    {
+        return readPBMEdgeMap(file_name);
+    }
+    else if (extension == "rle")
+    {
+        return readRLEEdgeMap(file_name);
+    }
+    else if (extension == "csv")
+    {
+        return readCSVEdgeMap(file_name, p_magnitude, p_direction);
+    }
+
+    cv::Mat image = cv::imread(file_name, cv::IMREAD_GRAYSCALE);
+    if (!image.data)
+    {
+        throw std::string("Could not open or find the edge map \"") + file_name + "\".";
+    }
+
+    cv::Mat edges;
+    cv::compare(image, 0.0, edges, cv::CMP_NE);
+    return edges;
+}
+
+
+#endif // EDGE_MAP_IO_H
@@ -0,0 +1,230 @@
+/**
+********************************************************************************
+*
+*   @file       framePacer.h
+*
+*   @brief      Presentation clock of the video programs of Lab-09. Frame i
+*               is due i frame periods after the first frame, so the time
+*               spent to decode, process and display a frame is taken out of
+*               the wait, instead of being added to a fixed delay. A frame
+*               more than one period late is dropped (not displayed) if the
+*               next frame is already there, and after a long pause (e.g.
+*               while the window is moved) the clock starts again from the
+*               current frame. In the maximum throughput mode there is no
+*               wait at all, and at most one frame per period is displayed,
+*               for offline runs. The jitter (time the frames are displayed
+*               minus the time they are due) and the dropped frames are
+*               reported.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::max
+#include <cmath>     // Header for sqrt and floor
+#include <iomanip>   // Header to format the statistics
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Frame rate used when the video does not give one (CV_CAP_PROP_FPS is 0).
+const double FRAME_PACER_DEFAULT_FPS = 30.0;
+
+/// Lateness, in frame periods, after which the clock starts again.
+const int FRAME_PACER_RESYNC_PERIOD_COUNT = 10;
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Decide when each frame is displayed, and measure the jitter.
+class FramePacer
+{
+public:
+    /// Pace the frames at fps frames per second, or as fast as possible if
+    /// max_throughput is true. fps must be positive.
+    FramePacer(double fps, bool max_throughput = false);
+
+    /// For the next frame, return false if it must be dropped, or true and
+    /// the number of milliseconds to wait before displaying it. A late frame
+    /// is only dropped if next_frame_ready is true: when the frames arrive
+    /// late, dropping them would leave the window frozen.
+    bool schedule(int& wait_milliseconds, bool next_frame_ready = true);
+
+    /// Record the time the frame accepted by schedule() is displayed.
+    void presented();
+
+    /// Print the numbers of frames displayed and dropped, and the jitter.
+    void printStatistics(std::ostream& output) const;
+
+    long getDisplayedCount() const { return m_displayed_count; }
+    long getDroppedCount() const { return m_dropped_count; }
+
+private:
+    int64 m_period_ticks;
+    bool m_max_throughput;
+
+    /// Time frame 0 is due, moved forward when the clock starts again
+    int64 m_start_ticks;
+
+    /// Time the frame accepted by schedule() is due
+    int64 m_due_ticks;
+
+    long m_frame_count;
+    long m_displayed_count;
+    long m_dropped_count;
+    long m_resync_count;
+
+    /// Sums of the jitter and of its square, in ticks, and largest jitter
+    double m_jitter_sum;
+    double m_jitter_square_sum;
+    int64 m_max_jitter_ticks;
+};
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-------------------------------------------------------------
+inline FramePacer::FramePacer(double fps, bool max_throughput):
+//-------------------------------------------------------------
+    m_period_ticks(0),
+    m_max_throughput(max_throughput),
+    m_start_ticks(0),
+    m_due_ticks(0),
+    m_frame_count(0),
+    m_displayed_count(0),
+    m_dropped_count(0),
+    m_resync_count(0),
+    m_jitter_sum(0.0),
+    m_jitter_square_sum(0.0),
+    m_max_jitter_ticks(0)
+{
+    if (!(fps > 0.0))
+    {
+        throw std::string("FramePacer: the frame rate must be positive.");
+    }
+
+    m_period_ticks = std::max(int64(1), int64(cv::getTickFrequency() / fps));
+}
+
+
+//-----------------------------------------------------------------------------
+inline bool FramePacer::schedule(int& wait_milliseconds, bool next_frame_ready)
+//-----------------------------------------------------------------------------
+{
+    int64 now(cv::getTickCount());
+    wait_milliseconds = 0;
+
+    // The first frame is due now
+    if (m_frame_count == 0)
+    {
+        m_start_ticks = now;
+    }
+
+    int64 due_ticks(m_start_ticks + m_frame_count * m_period_ticks);
+    ++m_frame_count;
+
+    // No wait, and no more than a frame per period on screen
+    if (m_max_throughput)
+    {
+        if (m_displayed_count && now < m_due_ticks + m_period_ticks)
+        {
+            ++m_dropped_count;
+            return false;
+        }
+
+        m_due_ticks = now;
+        return true;
+    }
+
+    // Long pause, this frame is due now
+    int64 lateness(now - due_ticks);
+    if (lateness > FRAME_PACER_RESYNC_PERIOD_COUNT * m_period_ticks)
+    {
+        m_start_ticks += lateness;
+        due_ticks = now;
+        lateness = 0;
+        ++m_resync_count;
+    }
+
+    // Too late, and the next frame can be displayed instead
+    if (lateness > m_period_ticks && next_frame_ready)
+    {
+        ++m_dropped_count;
+        return false;
+    }
+
+    m_due_ticks = due_ticks;
+    if (lateness < 0)
+    {
+        wait_milliseconds = int(std::floor(-1000.0 * lateness / cv::getTickFrequency() + 0.5));
+    }
+
+    return true;
+}
+
+
+//---------------------------------
+inline void FramePacer::presented()
+//---------------------------------
+{
+    int64 jitter_ticks(cv::getTickCount() - m_due_ticks);
+
+    ++m_displayed_count;
+    m_jitter_sum += double(jitter_ticks);
+    m_jitter_square_sum += double(jitter_ticks) * jitter_ticks;
+    m_max_jitter_ticks = std::max(m_max_jitter_ticks, jitter_ticks < 0 ? -jitter_ticks : jitter_ticks);
+}
+
+
+//-----------------------------------------------------------------
+inline void FramePacer::printStatistics(std::ostream& output) const
+//-----------------------------------------------------------------
+{
+    double milliseconds_per_tick(1000.0 / cv::getTickFrequency());
+    long count(std::max(1L, m_displayed_count));
+    double mean(m_jitter_sum / count);
+    double variance(std::max(0.0, m_jitter_square_sum / count - mean * mean));
+
+    output << "Frames displayed: " << m_displayed_count
+           << ", dropped: " << m_dropped_count
+           << " (" << std::fixed << std::setprecision(1)
+           << 100.0 * m_dropped_count / std::max(1L, m_frame_count) << "%)";
+
+    if (m_resync_count)
+    {
+        output << ", clock restarted " << m_resync_count << " times";
+    }
+    output << std::endl;
+
+    output << (m_max_throughput ? "Maximum throughput, " : "")
+           << "jitter (ms): mean " << std::setprecision(2) << mean * milliseconds_per_tick
+           << ", standard deviation " << std::sqrt(variance) * milliseconds_per_tick
+           << ", largest " << m_max_jitter_ticks * milliseconds_per_tick << std::endl;
+}
+
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,151 @@
+/**
+********************************************************************************
+*
+*   @file       imageLoader.h
+*
+*   @brief      Load an image decoding only what the pipeline downstream
+*               consumes. Tools that only use the luminance ask for the grey
+*               channel, and tools can ask for an image reduced by 2, 4 or 8.
+*               The request is turned into the matching cv::imread flag
+*               (IMREAD_GRAYSCALE, IMREAD_REDUCED_*): for JPEG files, libjpeg
+*               then skips the chroma and scales the image in the DCT
+*               domain, which is much cheaper than decoding the full colour
+*               image and converting or resizing it afterwards. Other formats
+*               are decoded in full and converted or resized by OpenCV.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <cstdlib>   // Header for atoi
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+// The reduced modes of cv::imread appeared in OpenCV 3.2
+#if CV_MAJOR_VERSION > 3 || (CV_MAJOR_VERSION == 3 && CV_MINOR_VERSION >= 2)
+#define HAS_IMREAD_REDUCED 1
+#endif
+
+
+//******************************************************************************
+//    Type declaration
+//******************************************************************************
+
+/// Channels consumed by the pipeline after the image is loaded.
+enum ImageChannels
+{
+    GREY_CHANNEL, ///< CV_8UC1 luminance
+    BGR_CHANNELS  ///< CV_8UC3, in the order of cv::imread
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Flag of cv::imread for the channels and the scale denominator (1, 2, 4 or 8).
+inline int getImreadFlag(ImageChannels channels, int scale_denominator);
+
+/// Load an image with only the channels and the resolution needed. The
+/// image is empty if it could not be loaded.
+inline cv::Mat loadImage(const std::string& file_name,
+                         ImageChannels channels,
+                         int scale_denominator = 1);
+
+/// If the argument is --scale=N, store N and return true. Throw an error if
+/// N is not 1, 2, 4 or 8.
+inline bool parseScaleOption(const std::string& argument, int& scale_denominator);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//---------------------------------------------------------------------
+inline int getImreadFlag(ImageChannels channels, int scale_denominator)
+//---------------------------------------------------------------------
+{
+    bool grey(channels == GREY_CHANNEL);
+
+    switch (scale_denominator)
+    {
+#ifdef HAS_IMREAD_REDUCED
+    case 2:
+        return grey ? cv::IMREAD_REDUCED_GRAYSCALE_2 : cv::IMREAD_REDUCED_COLOR_2;
+
+    case 4:
+        return grey ? cv::IMREAD_REDUCED_GRAYSCALE_4 : cv::IMREAD_REDUCED_COLOR_4;
+
+    case 8:
+        return grey ? cv::IMREAD_REDUCED_GRAYSCALE_8 : cv::IMREAD_REDUCED_COLOR_8;
+#endif
+
+    default:
+        return grey ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline cv::Mat loadImage(const std::string& file_name,
+                         ImageChannels channels,
+                         int scale_denominator)
+//------------------------------------------------------------------------------
+{
+    cv::Mat image = cv::imread(file_name, getImreadFlag(channels, scale_denominator));
+
+#ifndef HAS_IMREAD_REDUCED
+    // The decoder cannot reduce the image, resize it after decoding
+    if (image.data && scale_denominator > 1)
+    {
+        cv::resize(image, image, cv::Size(0, 0),
+            1.0 / scale_denominator, 1.0 / scale_denominator, cv::INTER_AREA);
+    }
+#endif
+
+    return image;
+}
+
+
+//-------------------------------------------------------------------------------
+inline bool parseScaleOption(const std::string& argument, int& scale_denominator)
+//-------------------------------------------------------------------------------
+{
+    if (argument.find("--scale=") != 0)
+    {
+        return false;
+    }
+
+    scale_denominator = atoi(argument.substr(std::string("--scale=").size()).c_str());
+
+    if (scale_denominator != 1 && scale_denominator != 2 &&
+        scale_denominator != 4 && scale_denominator != 8)
+    {
+        throw std::string("The scale must be 1, 2, 4 or 8 (the image is reduced by this factor).");
+    }
+
+    return true;
+}
+
+
+#endif // IMAGE_LOADER_H
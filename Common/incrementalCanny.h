@@ -0,0 +1,670 @@
+/**
+********************************************************************************
+*
+*   @file       incrementalCanny.h
+*
+*   @brief      Canny edge detector split in two steps, so that the edges can
+*               be detected again with new thresholds without computing the
+*               gradients again. setImage() computes the Sobel gradients and
+*               the non-maximum suppression once; detect() only runs the
+*               hysteresis. The tests are the same as in cv::Canny (3x3 Sobel
+*               operator, L1 norm of the gradient).
+*               The hysteresis is a flood fill from the strong pixels, which
+*               is serial. detectParallel() gives the same edges with a
+*               connected-component labelling instead: union-find in strips
+*               of rows in parallel, a merge along the borders of the
+*               strips, then a parallel pass that keeps the components that
+*               contain a strong pixel.
+*               With a mask, setImage() only computes the gradients in the
+*               tiles that contain a pixel of the mask, e.g. around the
+*               edges found at a coarse level of a pyramid (pyramidEdges.h).
+*               The tiles and the strips can be cancelled with a function
+*               checked before each of them, e.g. when a newer position of
+*               the sliders is waiting (LatestWinsWorker::isCancelled).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef INCREMENTAL_CANNY_H
+#define INCREMENTAL_CANNY_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm>  // Header for std::min and std::max
+#include <atomic>     // Header to stop the strips of a cancelled call
+#include <cmath>      // Header for floor
+#include <cstdlib>    // Header for abs
+#include <functional> // Header for the cancellation check
+#include <string>     // Header to manipulate strings
+#include <vector>     // Header to store the pixels to visit
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Size of the tiles of IncrementalCanny::setImage with a mask.
+const int INCREMENTAL_CANNY_TILE_SIZE = 64;
+
+/// Pixels read around a tile by IncrementalCanny: 1 for the gradients and 1
+/// for the non-maximum suppression.
+const int INCREMENTAL_CANNY_TILE_BORDER = 2;
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Canny edge detector that caches the suppressed gradient magnitudes.
+class IncrementalCanny
+{
+public:
+    IncrementalCanny():
+        m_active_pixel_count(0)
+    {}
+
+    explicit IncrementalCanny(const cv::Mat& image):
+        m_active_pixel_count(0)
+    {
+        setImage(image);
+    }
+
+    /// Compute the gradients of a CV_8UC1 image and keep the magnitude of
+    /// the local maxima only.
+    void setImage(const cv::Mat& image);
+
+    /// Same, but the gradients are only computed in the tiles of 64x64
+    /// pixels that contain a non-zero pixel of mask (CV_8UC1). The
+    /// magnitude is 0 in the other tiles, so they contain no edge.
+    void setImage(const cv::Mat& image, const cv::Mat& mask);
+
+    /// Same, for the tiles given by findMaskTiles(). Only the pixels of the
+    /// tiles and of a border of INCREMENTAL_CANNY_TILE_BORDER pixels around
+    /// them are read. is_cancelled (if given) is checked before each tile:
+    /// once it returns true, the other tiles are left at 0 and false is
+    /// returned.
+    bool setImage(const cv::Mat& image,
+                  const std::vector<cv::Rect>& tile_set,
+                  const std::function<bool()>& is_cancelled = std::function<bool()>());
+
+    /// Number of pixels whose gradient was computed by the last setImage.
+    size_t getActivePixelCount() const { return m_active_pixel_count; }
+
+    /// Edges (CV_8UC1, 0 or 255) for the given thresholds, using the cached
+    /// magnitudes. The thresholds are swapped if needed.
+    void detect(double low_threshold, double high_threshold, cv::Mat& edges) const;
+
+    /// Same as detect(), with a parallel hysteresis for large images.
+    /// is_cancelled (if given) is checked before each strip: once it
+    /// returns true, the edges are left incomplete and false is returned.
+    bool detectParallel(double low_threshold,
+                        double high_threshold,
+                        cv::Mat& edges,
+                        const std::function<bool()>& is_cancelled = std::function<bool()>()) const;
+
+    /// Magnitude of the gradient where it is a local maximum along its
+    /// direction, 0 elsewhere (CV_16UC1).
+    const cv::Mat& getSuppressedMagnitude() const
+    {
+        return m_suppressed_magnitude;
+    }
+
+private:
+    /// Suppressed magnitude of a region of the image only.
+    void suppressRegion(const cv::Mat& image, const cv::Rect& region);
+
+    /// Non-maximum suppression of a row, given the gradients and the
+    /// magnitudes of the previous, current and next rows.
+    static void suppressRow(const short* p_dx,
+                            const short* p_dy,
+                            const int* p_previous,
+                            const int* p_current,
+                            const int* p_next,
+                            unsigned short* p_suppressed,
+                            int count);
+
+    cv::Mat m_suppressed_magnitude;
+    size_t m_active_pixel_count;
+
+    /// State of each pixel during the hysteresis, with a border of 1 pixel
+    mutable cv::Mat m_map;
+    mutable std::vector<unsigned char*> m_stack;
+
+    /// Union-find forest of the candidates (-1 for the other pixels), and
+    /// whether the component of a root contains a strong pixel
+    mutable std::vector<int> m_parent;
+    mutable std::vector<unsigned char> m_strong;
+
+    int findRoot(int index) const;
+    void unite(int index, int neighbour) const;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Tiles of INCREMENTAL_CANNY_TILE_SIZE pixels that contain a non-zero pixel
+/// of mask (CV_8UC1), row by row.
+inline void findMaskTiles(const cv::Mat& mask, std::vector<cv::Rect>& tile_set);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//----------------------------------------------------------
+inline void IncrementalCanny::setImage(const cv::Mat& image)
+//----------------------------------------------------------
+{
+    if (image.type() != CV_8UC1)
+    {
+        throw std::string("IncrementalCanny only supports CV_8UC1 images.");
+    }
+
+    m_active_pixel_count = image.total();
+
+    // Same gradients as cv::Canny with an aperture of 3
+    cv::Mat dx, dy;
+    cv::Sobel(image, dx, CV_16S, 1, 0, 3, 1, 0, cv::BORDER_REPLICATE);
+    cv::Sobel(image, dy, CV_16S, 0, 1, 3, 1, 0, cv::BORDER_REPLICATE);
+
+    // L1 norm, with a border of 0 around the image
+    cv::Mat magnitude(image.rows + 2, image.cols + 2, CV_32SC1, cv::Scalar(0));
+    cv::parallel_for_(cv::Range(0, image.rows), [&](const cv::Range& range)
+    {
+        for (int y = range.start; y < range.end; ++y)
+        {
+            const short* p_dx = dx.ptr<short>(y);
+            const short* p_dy = dy.ptr<short>(y);
+            int* p_magnitude = magnitude.ptr<int>(y + 1) + 1;
+
+            for (int x = 0; x < image.cols; ++x)
+            {
+                p_magnitude[x] = std::abs(p_dx[x]) + std::abs(p_dy[x]);
+            }
+        }
+    });
+
+    // Non-maximum suppression
+    m_suppressed_magnitude.create(image.size(), CV_16UC1);
+    cv::parallel_for_(cv::Range(0, image.rows), [&](const cv::Range& range)
+    {
+        for (int y = range.start; y < range.end; ++y)
+        {
+            suppressRow(dx.ptr<short>(y),
+                        dy.ptr<short>(y),
+                        magnitude.ptr<int>(y) + 1,
+                        magnitude.ptr<int>(y + 1) + 1,
+                        magnitude.ptr<int>(y + 2) + 1,
+                        m_suppressed_magnitude.ptr<unsigned short>(y),
+                        image.cols);
+        }
+    });
+}
+
+
+//-------------------------------------------------------------------------------
+inline void IncrementalCanny::setImage(const cv::Mat& image, const cv::Mat& mask)
+//-------------------------------------------------------------------------------
+{
+    if (mask.empty())
+    {
+        setImage(image);
+        return;
+    }
+
+    if (image.type() != CV_8UC1 || mask.type() != CV_8UC1 || mask.size() != image.size())
+    {
+        throw std::string("IncrementalCanny only supports CV_8UC1 images, with a CV_8UC1 mask of the same size.");
+    }
+
+    std::vector<cv::Rect> tile_set;
+    findMaskTiles(mask, tile_set);
+    setImage(image, tile_set);
+}
+
+
+//------------------------------------------------------------------------------
+inline bool IncrementalCanny::setImage(const cv::Mat& image,
+                                       const std::vector<cv::Rect>& tile_set,
+                                       const std::function<bool()>& is_cancelled)
+//------------------------------------------------------------------------------
+{
+    if (image.type() != CV_8UC1)
+    {
+        throw std::string("IncrementalCanny only supports CV_8UC1 images.");
+    }
+
+    m_suppressed_magnitude.create(image.size(), CV_16UC1);
+    m_suppressed_magnitude.setTo(cv::Scalar(0));
+    m_active_pixel_count = 0;
+    for (size_t i = 0; i < tile_set.size(); ++i)
+    {
+        m_active_pixel_count += tile_set[i].area();
+    }
+
+    std::atomic<bool> cancelled(false);
+    cv::parallel_for_(cv::Range(0, int(tile_set.size())), [&](const cv::Range& range)
+    {
+        for (int i = range.start; i < range.end; ++i)
+        {
+            if (cancelled || (is_cancelled && is_cancelled()))
+            {
+                cancelled = true;
+                return;
+            }
+
+            suppressRegion(image, tile_set[i]);
+        }
+    });
+
+    return !cancelled;
+}
+
+
+//----------------------------------------------------------------------------------------
+inline void IncrementalCanny::suppressRegion(const cv::Mat& image, const cv::Rect& region)
+//----------------------------------------------------------------------------------------
+{
+    // The gradients need 1 pixel around the region, and the non-maximum
+    // suppression 1 more. The pixels of the window next to the region are
+    // therefore exact, the border of the image is handled as in setImage
+    cv::Rect window(region.x - 2, region.y - 2, region.width + 4, region.height + 4);
+    window &= cv::Rect(0, 0, image.cols, image.rows);
+
+    cv::Mat dx, dy;
+    cv::Sobel(image(window), dx, CV_16S, 1, 0, 3, 1, 0, cv::BORDER_REPLICATE);
+    cv::Sobel(image(window), dy, CV_16S, 0, 1, 3, 1, 0, cv::BORDER_REPLICATE);
+
+    cv::Mat magnitude(window.height + 2, window.width + 2, CV_32SC1, cv::Scalar(0));
+    for (int y = 0; y < window.height; ++y)
+    {
+        const short* p_dx = dx.ptr<short>(y);
+        const short* p_dy = dy.ptr<short>(y);
+        int* p_magnitude = magnitude.ptr<int>(y + 1) + 1;
+
+        for (int x = 0; x < window.width; ++x)
+        {
+            p_magnitude[x] = std::abs(p_dx[x]) + std::abs(p_dy[x]);
+        }
+    }
+
+    // Rows and columns of the region in the window
+    const int offset_x(region.x - window.x);
+    const int offset_y(region.y - window.y);
+    for (int y = 0; y < region.height; ++y)
+    {
+        int window_y(y + offset_y);
+
+        suppressRow(dx.ptr<short>(window_y) + offset_x,
+                    dy.ptr<short>(window_y) + offset_x,
+                    magnitude.ptr<int>(window_y) + 1 + offset_x,
+                    magnitude.ptr<int>(window_y + 1) + 1 + offset_x,
+                    magnitude.ptr<int>(window_y + 2) + 1 + offset_x,
+                    m_suppressed_magnitude.ptr<unsigned short>(region.y + y) + region.x,
+                    region.width);
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void IncrementalCanny::suppressRow(const short* p_dx,
+                                          const short* p_dy,
+                                          const int* p_previous,
+                                          const int* p_current,
+                                          const int* p_next,
+                                          unsigned short* p_suppressed,
+                                          int count)
+//------------------------------------------------------------------------------
+{
+    // Fixed-point tests of cv::Canny
+    const int shift(15);
+    const int tan_22_5(int(0.4142135623730950488016887242097 * (1 << shift) + 0.5));
+
+    for (int x = 0; x < count; ++x)
+    {
+        int m(p_current[x]);
+        int abs_dx(std::abs(p_dx[x]));
+        int abs_dy(std::abs(p_dy[x]) << shift);
+        int tan_22_5_dx(abs_dx * tan_22_5);
+        bool maximum;
+
+        // Horizontal gradient
+        if (abs_dy < tan_22_5_dx)
+        {
+            maximum = m > p_current[x - 1] && m >= p_current[x + 1];
+        }
+        // Vertical gradient
+        else if (abs_dy > tan_22_5_dx + (abs_dx << (shift + 1)))
+        {
+            maximum = m > p_previous[x] && m >= p_next[x];
+        }
+        // Diagonal gradient
+        else
+        {
+            int s((p_dx[x] ^ p_dy[x]) < 0 ? -1 : 1);
+            maximum = m > p_previous[x - s] && m > p_next[x + s];
+        }
+
+        p_suppressed[x] = maximum ? m : 0;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void IncrementalCanny::detect(double low_threshold,
+                                     double high_threshold,
+                                     cv::Mat& edges) const
+//------------------------------------------------------------------------------
+{
+    if (m_suppressed_magnitude.empty())
+    {
+        throw std::string("IncrementalCanny::detect called before setImage.");
+    }
+
+    const int low(int(std::floor(std::min(low_threshold, high_threshold))));
+    const int high(int(std::floor(std::max(low_threshold, high_threshold))));
+    const int rows(m_suppressed_magnitude.rows);
+    const int cols(m_suppressed_magnitude.cols);
+
+    // 0: candidate, 1: not an edge, 2: edge. The border is never an edge
+    m_map.create(rows + 2, cols + 2, CV_8UC1);
+    m_map.setTo(cv::Scalar(1));
+    m_stack.clear();
+
+    for (int y = 0; y < rows; ++y)
+    {
+        const unsigned short* p_suppressed = m_suppressed_magnitude.ptr<unsigned short>(y);
+        unsigned char* p_map = m_map.ptr<unsigned char>(y + 1) + 1;
+
+        for (int x = 0; x < cols; ++x)
+        {
+            int m(p_suppressed[x]);
+
+            if (m > high)
+            {
+                p_map[x] = 2;
+                m_stack.push_back(p_map + x);
+            }
+            else if (m > low)
+            {
+                p_map[x] = 0;
+            }
+        }
+    }
+
+    // Follow the candidates connected to the strong edges
+    const int step(int(m_map.step));
+    while (!m_stack.empty())
+    {
+        unsigned char* p_map = m_stack.back();
+        m_stack.pop_back();
+
+        unsigned char* p_neighbour_set[8] =
+        {
+            p_map - step - 1, p_map - step, p_map - step + 1,
+            p_map - 1,                      p_map + 1,
+            p_map + step - 1, p_map + step, p_map + step + 1
+        };
+
+        for (int i = 0; i < 8; ++i)
+        {
+            if (!*p_neighbour_set[i])
+            {
+                *p_neighbour_set[i] = 2;
+                m_stack.push_back(p_neighbour_set[i]);
+            }
+        }
+    }
+
+    // 255 for the edges, 0 elsewhere
+    edges.create(rows, cols, CV_8UC1);
+    for (int y = 0; y < rows; ++y)
+    {
+        const unsigned char* p_map = m_map.ptr<unsigned char>(y + 1) + 1;
+        unsigned char* p_edges = edges.ptr<unsigned char>(y);
+
+        for (int x = 0; x < cols; ++x)
+        {
+            p_edges[x] = p_map[x] == 2 ? 255 : 0;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline bool IncrementalCanny::detectParallel(double low_threshold,
+                                             double high_threshold,
+                                             cv::Mat& edges,
+                                             const std::function<bool()>& is_cancelled) const
+//------------------------------------------------------------------------------
+{
+    if (m_suppressed_magnitude.empty())
+    {
+        throw std::string("IncrementalCanny::detectParallel called before setImage.");
+    }
+
+    const int low(int(std::floor(std::min(low_threshold, high_threshold))));
+    const int high(int(std::floor(std::max(low_threshold, high_threshold))));
+    const int rows(m_suppressed_magnitude.rows);
+    const int cols(m_suppressed_magnitude.cols);
+
+    m_parent.resize(size_t(rows) * cols);
+    m_strong.resize(size_t(rows) * cols);
+
+    // Several strips per thread to balance the load. A strip only links
+    // its own pixels, so the strips do not share any tree
+    int strip_count(std::max(1, std::min(4 * cv::getNumThreads(), rows)));
+
+    // Label the candidates of each strip, linking every pixel to the
+    // neighbours that have already been visited
+    std::atomic<bool> cancelled(false);
+    cv::parallel_for_(cv::Range(0, strip_count), [&](const cv::Range& range)
+    {
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            if (cancelled || (is_cancelled && is_cancelled()))
+            {
+                cancelled = true;
+                return;
+            }
+
+            int first_row(rows * strip / strip_count);
+            int last_row(rows * (strip + 1) / strip_count);
+
+            for (int y = first_row; y < last_row; ++y)
+            {
+                const unsigned short* p_suppressed = m_suppressed_magnitude.ptr<unsigned short>(y);
+
+                for (int x = 0; x < cols; ++x)
+                {
+                    int index(y * cols + x);
+                    int m(p_suppressed[x]);
+
+                    if (m <= low)
+                    {
+                        m_parent[index] = -1;
+                        continue;
+                    }
+
+                    m_parent[index] = index;
+                    m_strong[index] = m > high;
+
+                    if (x > 0)
+                    {
+                        unite(index, index - 1);
+                    }
+
+                    if (y > first_row)
+                    {
+                        if (x > 0)
+                        {
+                            unite(index, index - cols - 1);
+                        }
+                        unite(index, index - cols);
+                        if (x < cols - 1)
+                        {
+                            unite(index, index - cols + 1);
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    if (cancelled)
+    {
+        return false;
+    }
+
+    // Merge the components along the borders of the strips
+    for (int strip = 1; strip < strip_count; ++strip)
+    {
+        int y(rows * strip / strip_count);
+
+        for (int x = 0; x < cols; ++x)
+        {
+            int index(y * cols + x);
+
+            if (m_parent[index] >= 0)
+            {
+                if (x > 0)
+                {
+                    unite(index, index - cols - 1);
+                }
+                unite(index, index - cols);
+                if (x < cols - 1)
+                {
+                    unite(index, index - cols + 1);
+                }
+            }
+        }
+    }
+
+    // Keep the components that contain a strong pixel. The forest is only
+    // read, so the roots are found without path compression
+    edges.create(rows, cols, CV_8UC1);
+    cv::parallel_for_(cv::Range(0, strip_count), [&](const cv::Range& range)
+    {
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            if (cancelled || (is_cancelled && is_cancelled()))
+            {
+                cancelled = true;
+                return;
+            }
+
+            for (int y = rows * strip / strip_count; y < rows * (strip + 1) / strip_count; ++y)
+            {
+                unsigned char* p_edges = edges.ptr<unsigned char>(y);
+
+                for (int x = 0; x < cols; ++x)
+                {
+                    int root(m_parent[y * cols + x]);
+
+                    if (root < 0)
+                    {
+                        p_edges[x] = 0;
+                        continue;
+                    }
+
+                    while (m_parent[root] != root)
+                    {
+                        root = m_parent[root];
+                    }
+
+                    p_edges[x] = m_strong[root] ? 255 : 0;
+                }
+            }
+        }
+    });
+
+    return !cancelled;
+}
+
+
+//----------------------------------------------------
+inline int IncrementalCanny::findRoot(int index) const
+//----------------------------------------------------
+{
+    // Path halving
+    while (m_parent[index] != index)
+    {
+        m_parent[index] = m_parent[m_parent[index]];
+        index = m_parent[index];
+    }
+
+    return index;
+}
+
+
+//-----------------------------------------------------------------
+inline void IncrementalCanny::unite(int index, int neighbour) const
+//-----------------------------------------------------------------
+{
+    // The neighbour is not a candidate
+    if (m_parent[neighbour] < 0)
+    {
+        return;
+    }
+
+    int root(findRoot(index));
+    int neighbour_root(findRoot(neighbour));
+
+    if (root == neighbour_root)
+    {
+        return;
+    }
+
+    // The smallest index becomes the root, so the roots do not depend on
+    // the order of the unions
+    if (neighbour_root < root)
+    {
+        std::swap(root, neighbour_root);
+    }
+
+    m_parent[neighbour_root] = root;
+    m_strong[root] |= m_strong[neighbour_root];
+}
+
+
+//-----------------------------------------------------------------------------
+inline void findMaskTiles(const cv::Mat& mask, std::vector<cv::Rect>& tile_set)
+//-----------------------------------------------------------------------------
+{
+    if (mask.type() != CV_8UC1)
+    {
+        throw std::string("findMaskTiles only supports CV_8UC1 masks.");
+    }
+
+    const int tile_size(INCREMENTAL_CANNY_TILE_SIZE);
+    tile_set.clear();
+    for (int y = 0; y < mask.rows; y += tile_size)
+    {
+        for (int x = 0; x < mask.cols; x += tile_size)
+        {
+            cv::Rect tile(x, y, std::min(tile_size, mask.cols - x), std::min(tile_size, mask.rows - y));
+
+            if (cv::countNonZero(mask(tile)))
+            {
+                tile_set.push_back(tile);
+            }
+        }
+    }
+}
+
+
+#endif // INCREMENTAL_CANNY_H
@@ -0,0 +1,274 @@
+/**
+********************************************************************************
+*
+*   @file       latestWinsWorker.h
+*
+*   @brief      Background thread for the slider callbacks of the interactive
+*               tools. The callback only posts the state of the sliders, and
+*               returns at once. Only the newest request is kept: posting
+*               replaces the request that is waiting, and makes the request
+*               being computed stale. The compute function gives up on a
+*               stale request: it checks isCancelled() between its steps, and
+*               before each strip or tile of the long ones
+*               (ThresholdStatistics::threshold,
+*               IncrementalCanny::detectParallel, PyramidCanny::update). The
+*               result of a stale request is never published. Each request is
+*               computed in two passes, a low resolution preview then the
+*               full result, so that the window can be updated quickly while
+*               a slider is dragged. HighGUI must only be used from the main
+*               thread, so the results are collected by polling takeResult()
+*               from the event loop (cv::waitKey with a timeout).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef LATEST_WINS_WORKER_H
+#define LATEST_WINS_WORKER_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <atomic>             // Header for the request counter
+#include <condition_variable> // Header to wait for the requests
+#include <functional>         // Header to store the compute function
+#include <mutex>              // Header to protect the request and the result
+#include <thread>             // Header for the background thread
+#include <utility>            // Header for std::swap
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Worker thread that only computes the newest request.
+template<typename Request, typename Result> class LatestWinsWorker
+{
+public:
+    /// Compute the result of a request, either a quick preview or the full
+    /// result. Return false if there is nothing to publish, e.g. if
+    /// isCancelled() became true or if no preview is needed.
+    typedef std::function<bool(const Request& request, bool preview, Result& result)> Function;
+
+    LatestWinsWorker():
+        m_generation(0),
+        m_running_generation(0),
+        m_busy(false),
+        m_has_request(false),
+        m_has_result(false),
+        m_result_is_preview(false),
+        m_stop(false)
+    {}
+
+    ~LatestWinsWorker()
+    {
+        stop();
+    }
+
+    /// Start the thread.
+    void start(const Function& function);
+
+    /// Stop the thread, after the pass in progress.
+    void stop();
+
+    /// Replace the pending request, and cancel the one in progress.
+    void post(const Request& request);
+
+    /// For the compute function: true if a newer request has been posted.
+    bool isCancelled() const
+    {
+        return m_generation.load() != m_running_generation;
+    }
+
+    /// Get the newest result that has not been taken yet, with its request.
+    /// Return false if there is none.
+    bool takeResult(Result& result, Request* p_request = 0, bool* p_preview = 0);
+
+    /// Wait until the newest request has been fully computed.
+    void waitUntilIdle();
+
+private:
+    void run();
+
+    Function m_function;
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_request_condition;
+    std::condition_variable m_idle_condition;
+
+    /// Incremented by post(), compared by isCancelled()
+    std::atomic<unsigned int> m_generation;
+
+    /// Generation of the request in progress, only used by the thread
+    unsigned int m_running_generation;
+    bool m_busy;
+
+    Request m_request;
+    bool m_has_request;
+
+    Result m_result;
+    Request m_result_request;
+    bool m_has_result;
+    bool m_result_is_preview;
+
+    bool m_stop;
+};
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------------------------------------------
+template<typename Request, typename Result> void LatestWinsWorker<Request, Result>::start(const Function& function)
+//-----------------------------------------------------------------------------------------------------------------
+{
+    stop();
+
+    m_function = function;
+    m_stop = false;
+    m_thread = std::thread(&LatestWinsWorker::run, this);
+}
+
+
+//----------------------------------------------------------------------------------------
+template<typename Request, typename Result> void LatestWinsWorker<Request, Result>::stop()
+//----------------------------------------------------------------------------------------
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        ++m_generation;
+    }
+
+    m_request_condition.notify_all();
+    m_thread.join();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------
+template<typename Request, typename Result> void LatestWinsWorker<Request, Result>::post(const Request& request)
+//--------------------------------------------------------------------------------------------------------------
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_request = request;
+        m_has_request = true;
+        ++m_generation;
+    }
+
+    m_request_condition.notify_one();
+}
+
+
+//------------------------------------------------------------------------------
+template<typename Request, typename Result> bool LatestWinsWorker<Request, Result>::takeResult(Result& result,
+                                                                                             Request* p_request,
+                                                                                             bool* p_preview)
+//------------------------------------------------------------------------------
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_has_result)
+    {
+        return false;
+    }
+
+    // The worker does not get the buffers back: the caller may keep them
+    result = m_result;
+    m_result = Result();
+    if (p_request)
+    {
+        *p_request = m_result_request;
+    }
+    if (p_preview)
+    {
+        *p_preview = m_result_is_preview;
+    }
+    m_has_result = false;
+
+    return true;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+template<typename Request, typename Result> void LatestWinsWorker<Request, Result>::waitUntilIdle()
+//-------------------------------------------------------------------------------------------------
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle_condition.wait(lock, [this] { return m_stop || (!m_has_request && !m_busy); });
+}
+
+
+//---------------------------------------------------------------------------------------
+template<typename Request, typename Result> void LatestWinsWorker<Request, Result>::run()
+//---------------------------------------------------------------------------------------
+{
+    Request request;
+    Result result;
+
+    for (;;)
+    {
+        // Wait for a request
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_busy = false;
+            m_idle_condition.notify_all();
+            m_request_condition.wait(lock, [this] { return m_stop || m_has_request; });
+
+            if (m_stop)
+            {
+                m_idle_condition.notify_all();
+                return;
+            }
+
+            request = m_request;
+            m_has_request = false;
+            m_running_generation = m_generation.load();
+            m_busy = true;
+        }
+
+        // Preview, then full result
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            bool preview(pass == 0);
+
+            if (isCancelled() || !m_function(request, preview, result))
+            {
+                continue;
+            }
+
+            // The result of a stale request is dropped
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_generation.load() == m_running_generation)
+            {
+                std::swap(m_result, result);
+                m_result_request = request;
+                m_result_is_preview = preview;
+                m_has_result = true;
+            }
+        }
+    }
+}
+
+
+#endif // LATEST_WINS_WORKER_H
@@ -0,0 +1,161 @@
+/**
+********************************************************************************
+*
+*   @file       matAllocationCounter.h
+*
+*   @brief      A cv::MatAllocator that counts the images allocated by each
+*               thread, and hands the memory over to the allocator it
+*               replaces. Once installed as the default allocator of
+*               cv::Mat, every cv::Mat::create() that needs new memory is
+*               counted, including the temporary images created inside the
+*               OpenCV functions, which is how the programs check that
+*               their buffers are reused from one frame to the next. The
+*               memory allocated without cv::Mat (std::vector,
+*               cv::AutoBuffer) is not counted.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef MAT_ALLOCATION_COUNTER_H
+#define MAT_ALLOCATION_COUNTER_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Count the images allocated by cv::Mat. The count is per thread, so that
+/// several threads can each check their own buffers.
+class MatAllocationCounter: public cv::MatAllocator
+{
+public:
+#if CV_MAJOR_VERSION >= 4
+    typedef cv::AccessFlag AccessFlag;
+#else
+    typedef int AccessFlag;
+#endif
+
+    /// Make the counter the default allocator of cv::Mat. Only the first
+    /// call installs it, the next ones do nothing. The images allocated
+    /// before are not counted.
+    static void install();
+
+    /// Number of images allocated by the calling thread since it started,
+    /// always 0 if the counter is not installed.
+    static long getThreadCount() { return getThreadCounter(); }
+
+    cv::UMatData* allocate(int dims,
+                           const int* p_size_set,
+                           int type,
+                           void* p_data,
+                           size_t* p_step_set,
+                           AccessFlag flags,
+                           cv::UMatUsageFlags usage_flags) const;
+
+    bool allocate(cv::UMatData* p_data, AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const;
+
+    void deallocate(cv::UMatData* p_data) const;
+
+private:
+    explicit MatAllocationCounter(cv::MatAllocator* p_allocator):
+        m_p_allocator(p_allocator)
+    {}
+
+    /// Create the counter and make it the default allocator.
+    static MatAllocationCounter* createDefaultAllocator();
+
+    static long& getThreadCounter();
+
+    /// Allocator that owns the memory
+    cv::MatAllocator* m_p_allocator;
+};
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------------------
+inline void MatAllocationCounter::install()
+//-----------------------------------------
+{
+    // A function-local static is only initialised once, even by several
+    // threads
+    static MatAllocationCounter* p_counter(createDefaultAllocator());
+    (void)p_counter;
+}
+
+
+//-----------------------------------------------------------
+inline cv::UMatData* MatAllocationCounter::allocate(int dims,
+                                                    const int* p_size_set,
+                                                    int type,
+                                                    void* p_data,
+                                                    size_t* p_step_set,
+                                                    AccessFlag flags,
+                                                    cv::UMatUsageFlags usage_flags) const
+//-----------------------------------------------------------
+{
+    // An image that wraps the memory of the user is not an allocation
+    if (!p_data)
+    {
+        ++getThreadCounter();
+    }
+
+    return m_p_allocator->allocate(dims, p_size_set, type, p_data, p_step_set, flags, usage_flags);
+}
+
+
+//-----------------------------------------------------------------------------------------------------------------------------
+inline bool MatAllocationCounter::allocate(cv::UMatData* p_data, AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const
+//-----------------------------------------------------------------------------------------------------------------------------
+{
+    return m_p_allocator->allocate(p_data, access_flags, usage_flags);
+}
+
+
+//----------------------------------------------------------------------
+inline void MatAllocationCounter::deallocate(cv::UMatData* p_data) const
+//----------------------------------------------------------------------
+{
+    m_p_allocator->deallocate(p_data);
+}
+
+
+//---------------------------------------------------
+inline long& MatAllocationCounter::getThreadCounter()
+//---------------------------------------------------
+{
+    static thread_local long count(0);
+    return count;
+}
+
+
+//-------------------------------------------------------------------------
+inline MatAllocationCounter* MatAllocationCounter::createDefaultAllocator()
+//-------------------------------------------------------------------------
+{
+    // The counter is never deleted: the images allocated with it may be
+    // released at any time, until the program exits
+    MatAllocationCounter* p_counter(new MatAllocationCounter(cv::Mat::getDefaultAllocator()));
+    cv::Mat::setDefaultAllocator(p_counter);
+    return p_counter;
+}
+
+
+#endif // MAT_ALLOCATION_COUNTER_H
@@ -0,0 +1,183 @@
+/**
+********************************************************************************
+*
+*   @file       panelCompositor.h
+*
+*   @brief      Side-by-side display of several images (panels) in a single
+*               window, as in edgeDetection2 and edgeDetection3. The canvas
+*               is 8-bit, so it is 4 times smaller than a float canvas and
+*               cv::imshow does not convert it. When the panels side by side
+*               would be larger than the screen, they are downscaled once,
+*               when they are set. Setting a panel only updates its region
+*               of the canvas, and the window is only redrawn if a panel has
+*               changed since the last call to show().
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef PANEL_COMPOSITOR_H
+#define PANEL_COMPOSITOR_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min and std::max
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the regions of the panels
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Largest canvas shown without downscaling. OpenCV cannot query the size of
+/// the screen, so a full HD screen is assumed.
+const cv::Size PANEL_COMPOSITOR_SCREEN_SIZE(1920, 1080);
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// 8-bit canvas of panels of the same size separated by a gap.
+class PanelCompositor
+{
+public:
+    PanelCompositor():
+        m_display_scale(1.0),
+        m_dirty(false)
+    {}
+
+    /// Create the canvas for panel_count panels of panel_size pixels,
+    /// separated by gap pixels, filled with the background grey level. The
+    /// canvas is downscaled to fit in screen_size.
+    void create(int panel_count,
+                const cv::Size& panel_size,
+                int gap,
+                unsigned char background = 128,
+                const cv::Size& screen_size = PANEL_COMPOSITOR_SCREEN_SIZE);
+
+    /// Copy a single-channel image in a panel. The pixel values are
+    /// multiplied by scale and saturated to [0, 255], e.g. scale is 255 for a
+    /// float image in [0, 1] and 1 for an 8-bit image. The image is resized
+    /// to the panel if needed, so a reduced preview can also be shown.
+    void setPanel(int index, const cv::Mat& image, double scale = 1.0);
+
+    /// Display the canvas if a panel has changed since the last call.
+    void show(const std::string& window_title);
+
+    /// Size of the panels in the canvas over their original size (at most 1).
+    double getDisplayScale() const { return m_display_scale; }
+
+    /// Size of the panels in the canvas.
+    cv::Size getDisplayPanelSize() const
+    {
+        return m_panel_rects.empty() ? cv::Size() : m_panel_rects[0].size();
+    }
+
+    const cv::Mat& getCanvas() const { return m_canvas; }
+
+private:
+    cv::Mat m_canvas;
+    cv::Mat m_resized_image;
+    std::vector<cv::Rect> m_panel_rects;
+    double m_display_scale;
+    bool m_dirty;
+};
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------
+inline void PanelCompositor::create(int panel_count,
+                                    const cv::Size& panel_size,
+                                    int gap,
+                                    unsigned char background,
+                                    const cv::Size& screen_size)
+//-----------------------------------------------------------------------------
+{
+    if (panel_count < 1 || panel_size.width < 1 || panel_size.height < 1 || gap < 0)
+    {
+        throw std::string("PanelCompositor: invalid layout.");
+    }
+
+    // Scale of the whole canvas, the gaps included
+    int full_width(panel_size.width * panel_count + gap * (panel_count - 1));
+    m_display_scale = std::min(1.0, std::min(double(screen_size.width) / full_width,
+                                             double(screen_size.height) / panel_size.height));
+
+    int width(std::max(1, int(panel_size.width * m_display_scale)));
+    int height(std::max(1, int(panel_size.height * m_display_scale)));
+    int scaled_gap(int(gap * m_display_scale));
+
+    m_panel_rects.clear();
+    for (int i = 0; i < panel_count; ++i)
+    {
+        m_panel_rects.push_back(cv::Rect(i * (width + scaled_gap), 0, width, height));
+    }
+
+    m_canvas.create(height, width * panel_count + scaled_gap * (panel_count - 1), CV_8UC1);
+    m_canvas.setTo(cv::Scalar(background));
+    m_dirty = true;
+}
+
+
+//---------------------------------------------------------------------------------
+inline void PanelCompositor::setPanel(int index, const cv::Mat& image, double scale)
+//---------------------------------------------------------------------------------
+{
+    if (index < 0 || index >= int(m_panel_rects.size()))
+    {
+        throw std::string("PanelCompositor: invalid panel index.");
+    }
+
+    if (image.channels() != 1 || image.empty())
+    {
+        throw std::string("PanelCompositor: a panel must be a single-channel image.");
+    }
+
+    // The size and the type of the ROI match, convertTo writes in the canvas
+    cv::Mat target_roi = m_canvas(m_panel_rects[index]);
+    if (m_panel_rects[index].size() == image.size())
+    {
+        image.convertTo(target_roi, CV_8UC1, scale);
+    }
+    // Average the pixels before the conversion, so that thin edges remain
+    // visible (a preview smaller than the panel is enlarged)
+    else
+    {
+        int interpolation(image.cols > target_roi.cols ? cv::INTER_AREA : cv::INTER_NEAREST);
+        cv::resize(image, m_resized_image, target_roi.size(), 0, 0, interpolation);
+        m_resized_image.convertTo(target_roi, CV_8UC1, scale);
+    }
+
+    m_dirty = true;
+}
+
+
+//-------------------------------------------------------------------
+inline void PanelCompositor::show(const std::string& window_title)
+//-------------------------------------------------------------------
+{
+    if (m_dirty)
+    {
+        cv::imshow(window_title, m_canvas);
+        m_dirty = false;
+    }
+}
+
+
+#endif // PANEL_COMPOSITOR_H
@@ -0,0 +1,381 @@
+/**
+********************************************************************************
+*
+*   @file       pointOperation.h
+*
+*   @brief      Point operations (log scale, gamma, contrast stretch, negative)
+*               on 8-bit images. An 8-bit to 8-bit point operation is fully
+*               described by a 256-entry lookup table, so the table is built
+*               once and applied in a single pass. When the operation needs
+*               the range of the intensities (log scale, contrast stretch),
+*               it is found from a histogram computed in a first pass.
+*               The contrast stretch also has a float version, whose table
+*               has 256 floats in [0, 1].
+*
+*               BGR images are converted to greyscale on the fly, one row at
+*               a time, in both passes, so no greyscale or float temporary
+*               is created.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef POINT_OPERATION_H
+#define POINT_OPERATION_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min and std::max
+#include <cmath>     // Header for log and pow
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the partial histograms
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "bgrToGrey.h" // SIMD BGR to greyscale conversion
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// An 8-bit to 8-bit transform of the intensity.
+class PointOperation
+{
+public:
+    enum Type
+    {
+        IDENTITY,
+        LOG_SCALE,        ///< log(1 + v), normalised between min and max
+        GAMMA,            ///< 255 * (v / 255)^gamma
+        CONTRAST_STRETCH, ///< linear, normalised between min and max
+        NEGATIVE          ///< 255 - v
+    };
+
+    explicit PointOperation(Type type = IDENTITY, double gamma = 1.0):
+        m_type(type),
+        m_gamma(gamma)
+    {}
+
+    static PointOperation logScale()
+    {
+        return PointOperation(LOG_SCALE);
+    }
+
+    static PointOperation gamma(double gamma)
+    {
+        return PointOperation(GAMMA, gamma);
+    }
+
+    static PointOperation contrastStretch()
+    {
+        return PointOperation(CONTRAST_STRETCH);
+    }
+
+    static PointOperation negative()
+    {
+        return PointOperation(NEGATIVE);
+    }
+
+    /// True if the table depends on the min and max intensities of the image.
+    bool needsRange() const
+    {
+        return m_type == LOG_SCALE || m_type == CONTRAST_STRETCH;
+    }
+
+    /// Fill the 256 entries of the lookup table.
+    void buildTable(int min, int max, unsigned char* p_table) const;
+
+private:
+    Type m_type;
+    double m_gamma;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Histogram of a CV_8UC1 image, or of the greyscale of a CV_8UC3 BGR image.
+inline void computeGreyHistogram(const cv::Mat& image, std::vector<int>& histogram);
+
+/// Smallest and largest intensities present in a histogram.
+inline void getHistogramRange(const std::vector<int>& histogram, int& min, int& max);
+
+/// Apply a lookup table to a CV_8UC1 image, or to the greyscale of a
+/// CV_8UC3 BGR image. If p_grey is given and the input is BGR, the
+/// greyscale image is also written, in the same pass.
+inline void applyLookUpTable(const cv::Mat& image,
+                             const unsigned char* p_table,
+                             cv::Mat& dst,
+                             cv::Mat* p_grey = 0);
+
+/// Histogram pass (if needed), then lookup table pass.
+inline void applyPointOperation(const cv::Mat& image,
+                                const PointOperation& operation,
+                                cv::Mat& dst,
+                                cv::Mat* p_grey = 0);
+
+/// Contrast stretch of a CV_8UC1 image, or of the greyscale of a CV_8UC3
+/// BGR image, into a CV_32FC1 image in [0, 1]. Same result as convertTo
+/// followed by cv::normalize(..., 0.0, 1.0, NORM_MINMAX), in two passes
+/// over the 8-bit image.
+inline void contrastStretchFloat(const cv::Mat& image, cv::Mat& dst);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//------------------------------------------------------------------------------------
+inline void PointOperation::buildTable(int min, int max, unsigned char* p_table) const
+//------------------------------------------------------------------------------------
+{
+    for (int v = 0; v < 256; ++v)
+    {
+        double value(v);
+        int clamped(std::max(min, std::min(v, max)));
+
+        switch (m_type)
+        {
+        case LOG_SCALE:
+            // Same as 255 * (log(1 + v) - log(1 + min)) / (log(1 + max) - log(1 + min))
+            if (max > min)
+            {
+                value = 255.0 * (std::log(1.0 + clamped) - std::log(1.0 + min)) /
+                    (std::log(1.0 + max) - std::log(1.0 + min));
+            }
+            else
+            {
+                value = 0.0;
+            }
+            break;
+
+        case GAMMA:
+            value = 255.0 * std::pow(v / 255.0, m_gamma);
+            break;
+
+        case CONTRAST_STRETCH:
+            if (max > min)
+            {
+                value = 255.0 * double(clamped - min) / double(max - min);
+            }
+            else
+            {
+                value = 0.0;
+            }
+            break;
+
+        case NEGATIVE:
+            value = 255.0 - v;
+            break;
+
+        default:
+            break;
+        }
+
+        p_table[v] = cv::saturate_cast<unsigned char>(value);
+    }
+}
+
+
+//---------------------------------------------------------------------------------
+inline void computeGreyHistogram(const cv::Mat& image, std::vector<int>& histogram)
+//---------------------------------------------------------------------------------
+{
+    if (image.depth() != CV_8U || (image.channels() != 1 && image.channels() != 3))
+    {
+        throw std::string("Point operations only support 8-bit greyscale or BGR images.");
+    }
+
+    // One histogram per strip, merged at the end
+    int strip_count(std::max(1, std::min(cv::getNumThreads(), image.rows)));
+    std::vector<int> partial_histograms(strip_count * 256, 0);
+
+    cv::parallel_for_(cv::Range(0, strip_count), [&](const cv::Range& range)
+    {
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            int* p_histogram = &partial_histograms[strip * 256];
+            std::vector<unsigned char> grey_row(image.cols);
+            for (int y = image.rows * strip / strip_count; y < image.rows * (strip + 1) / strip_count; ++y)
+            {
+                const unsigned char* p_input = image.ptr<unsigned char>(y);
+
+                if (image.channels() == 1)
+                {
+                    for (int x = 0; x < image.cols; ++x)
+                    {
+                        ++p_histogram[p_input[x]];
+                    }
+                }
+                else
+                {
+                    bgrToGreyRow(p_input, &grey_row[0], 0, image.cols);
+                    for (int x = 0; x < image.cols; ++x)
+                    {
+                        ++p_histogram[grey_row[x]];
+                    }
+                }
+            }
+        }
+    });
+
+    histogram.assign(256, 0);
+    for (int strip = 0; strip < strip_count; ++strip)
+    {
+        for (int v = 0; v < 256; ++v)
+        {
+            histogram[v] += partial_histograms[strip * 256 + v];
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------------
+inline void getHistogramRange(const std::vector<int>& histogram, int& min, int& max)
+//----------------------------------------------------------------------------------
+{
+    min = 0;
+    while (min < 255 && !histogram[min])
+    {
+        ++min;
+    }
+
+    max = 255;
+    while (max > min && !histogram[max])
+    {
+        --max;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void applyLookUpTable(const cv::Mat& image,
+                             const unsigned char* p_table,
+                             cv::Mat& dst,
+                             cv::Mat* p_grey)
+//------------------------------------------------------------------------------
+{
+    if (image.depth() != CV_8U || (image.channels() != 1 && image.channels() != 3))
+    {
+        throw std::string("Point operations only support 8-bit greyscale or BGR images.");
+    }
+
+    // Greyscale input, OpenCV has an optimised LUT
+    if (image.channels() == 1)
+    {
+        cv::LUT(image, cv::Mat(1, 256, CV_8UC1, const_cast<unsigned char*>(p_table)), dst);
+
+        if (p_grey)
+        {
+            *p_grey = image;
+        }
+        return;
+    }
+
+    dst.create(image.size(), CV_8UC1);
+    if (p_grey)
+    {
+        p_grey->create(image.size(), CV_8UC1);
+    }
+
+    // BGR input, convert and map each row in the same pass
+    cv::parallel_for_(cv::Range(0, image.rows), [&](const cv::Range& range)
+    {
+        std::vector<unsigned char> grey_row(p_grey ? 0 : image.cols);
+
+        for (int y = range.start; y < range.end; ++y)
+        {
+            unsigned char* p_output = dst.ptr<unsigned char>(y);
+            unsigned char* p_grey_output = p_grey ? p_grey->ptr<unsigned char>(y) : &grey_row[0];
+
+            bgrToGreyRow(image.ptr<unsigned char>(y), p_grey_output, 0, image.cols);
+            for (int x = 0; x < image.cols; ++x)
+            {
+                p_output[x] = p_table[p_grey_output[x]];
+            }
+        }
+    });
+}
+
+
+//------------------------------------------------------------------------------
+inline void applyPointOperation(const cv::Mat& image,
+                                const PointOperation& operation,
+                                cv::Mat& dst,
+                                cv::Mat* p_grey)
+//------------------------------------------------------------------------------
+{
+    int min(0), max(255);
+
+    if (operation.needsRange())
+    {
+        std::vector<int> histogram;
+        computeGreyHistogram(image, histogram);
+        getHistogramRange(histogram, min, max);
+    }
+
+    unsigned char table[256];
+    operation.buildTable(min, max, table);
+
+    applyLookUpTable(image, table, dst, p_grey);
+}
+
+
+//------------------------------------------------------------------
+inline void contrastStretchFloat(const cv::Mat& image, cv::Mat& dst)
+//------------------------------------------------------------------
+{
+    std::vector<int> histogram;
+    computeGreyHistogram(image, histogram);
+
+    int min(0), max(255);
+    getHistogramRange(histogram, min, max);
+
+    // Same scale and shift as cv::normalize, applied in float as
+    // cv::Mat::convertTo. A constant image becomes 0.
+    double scale(max > min ? 1.0 / (max - min) : 0.0);
+    double shift(-min * scale);
+    float table[256];
+    for (int v = 0; v < 256; ++v)
+    {
+        table[v] = float(v) * float(scale) + float(shift);
+    }
+
+    dst.create(image.size(), CV_32FC1);
+
+    cv::parallel_for_(cv::Range(0, image.rows), [&](const cv::Range& range)
+    {
+        std::vector<unsigned char> grey_row(image.channels() == 1 ? 0 : image.cols);
+
+        for (int y = range.start; y < range.end; ++y)
+        {
+            const unsigned char* p_grey = image.ptr<unsigned char>(y);
+            float* p_output = dst.ptr<float>(y);
+
+            if (image.channels() != 1)
+            {
+                bgrToGreyRow(p_grey, &grey_row[0], 0, image.cols);
+                p_grey = &grey_row[0];
+            }
+
+            for (int x = 0; x < image.cols; ++x)
+            {
+                p_output[x] = table[p_grey[x]];
+            }
+        }
+    });
+}
+
+
+#endif // POINT_OPERATION_H
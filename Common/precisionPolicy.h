@@ -0,0 +1,132 @@
+/**
+********************************************************************************
+*
+*   @file       precisionPolicy.h
+*
+*   @brief      Precision policies of the edge pipeline (3x3 Gaussian filter,
+*               Scharr gradient magnitude, threshold or Canny). The kernels
+*               are templates on the policy, so the arithmetic is chosen at
+*               compile time:
+*               - FixedPointPrecision: 8-bit images, 32-bit integer sums,
+*                 16-bit magnitudes in grey levels. This is the default, it
+*                 moves 2 to 4 times less data than the float pipeline and
+*                 Canny can use the blurred image directly;
+*               - FloatPrecision: images in [0, 1] stored as float, as in the
+*                 original labs, for validation.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef PRECISION_POLICY_H
+#define PRECISION_POLICY_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <cmath>     // Header for floor
+#include <cstdlib>   // Header for abs
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// 8-bit pixels, integer arithmetic.
+struct FixedPointPrecision
+{
+    typedef unsigned char Pixel;
+    typedef int Accumulator;
+    typedef short Magnitude;
+
+    enum
+    {
+        PIXEL_TYPE = CV_8UC1,
+        MAGNITUDE_TYPE = CV_16SC1
+    };
+
+    /// Weights of the 3x3 Gaussian kernel (sigma 0.5) in Q8, their sum is
+    /// exactly 256.
+    static void getGaussianKernel(Accumulator p_kernel[3])
+    {
+        cv::Mat kernel = cv::getGaussianKernel(3, 0.5, CV_64F);
+        p_kernel[0] = p_kernel[2] = Accumulator(std::floor(kernel.at<double>(0, 0) * 256.0 + 0.5));
+        p_kernel[1] = 256 - 2 * p_kernel[0];
+    }
+
+    /// The vertical and horizontal passes give Q16 sums, round them.
+    static Accumulator normaliseBlur(Accumulator value)
+    {
+        return (value + (1 << 15)) >> 16;
+    }
+
+    /// 0.5 * |gx| + 0.5 * |gy|, rounded.
+    static Magnitude getMagnitude(Accumulator gx, Accumulator gy)
+    {
+        return Magnitude((std::abs(gx) + std::abs(gy) + 1) >> 1);
+    }
+};
+
+
+/// Float pixels in [0, 1].
+struct FloatPrecision
+{
+    typedef float Pixel;
+    typedef float Accumulator;
+    typedef float Magnitude;
+
+    enum
+    {
+        PIXEL_TYPE = CV_32FC1,
+        MAGNITUDE_TYPE = CV_32FC1
+    };
+
+    /// Weights of the 3x3 Gaussian kernel (sigma 0.5).
+    static void getGaussianKernel(Accumulator p_kernel[3])
+    {
+        cv::Mat kernel = cv::getGaussianKernel(3, 0.5, CV_32F);
+        for (int k = 0; k < 3; ++k)
+        {
+            p_kernel[k] = kernel.at<float>(k, 0);
+        }
+    }
+
+    static Accumulator normaliseBlur(Accumulator value)
+    {
+        return value;
+    }
+
+    /// 0.5 * |gx| + 0.5 * |gy|.
+    static Magnitude getMagnitude(Accumulator gx, Accumulator gy)
+    {
+        return 0.5f * std::abs(gx) + 0.5f * std::abs(gy);
+    }
+};
+
+
+/// Precision of the edge detectors unless --float is given.
+typedef FixedPointPrecision DefaultEdgePrecision;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Factor that converts the pixels or the magnitudes of an image of the edge
+/// pipeline to the units of the float pipeline (1/255 for the fixed point).
+inline double getUnitScale(const cv::Mat& image)
+{
+    return image.depth() == CV_32F ? 1.0 : 1.0 / 255.0;
+}
+
+
+#endif // PRECISION_POLICY_H
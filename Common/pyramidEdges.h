@@ -0,0 +1,428 @@
+/**
+********************************************************************************
+*
+*   @file       pyramidEdges.h
+*
+*   @brief      Coarse-to-fine Canny edge detection for very large images
+*               that are mostly flat background. The edge pipeline (3x3
+*               Gaussian filter, gradients and non-maximum suppression) is
+*               first run on a reduced level of a Gaussian pyramid. The
+*               pixels whose suppressed magnitude is above a small threshold,
+*               at most the low threshold of the hysteresis, are brought
+*               back to full resolution and dilated. The full resolution
+*               Gaussian filter and gradients are then only computed in the
+*               tiles that contain this mask (IncrementalCanny::setImage with
+*               tiles), and the hysteresis runs as usual. PyramidCanny
+*               computes the mask again when the low threshold decreases.
+*               The edges can only be missed where the coarse level does not
+*               see them, e.g. fine texture of low contrast, so the result
+*               should be compared to the full resolution edges for the
+*               images at hand (see pyramidEdgeReport.cxx).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef PYRAMID_EDGES_H
+#define PYRAMID_EDGES_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm>  // Header for std::min, std::max and std::sort
+#include <cstdlib>    // Header for atoi
+#include <functional> // Header for the cancellation check
+#include <string>     // Header to manipulate strings
+#include <vector>     // Header to store the tiles
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "incrementalCanny.h" // Canny with cached gradients
+#include "scharrMagnitude.h"  // 3x3 Gaussian filter
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Suppressed magnitude (L1 norm of the Sobel gradient, as in Canny) above
+/// which a pixel of the coarse level is kept in the mask, if the low
+/// threshold of the hysteresis is not lower (see getPyramidMaskMagnitude).
+const double PYRAMID_EDGE_MIN_MAGNITUDE = 32.0;
+
+/// Largest number of reductions of the image.
+const int PYRAMID_EDGE_MAX_LEVEL_COUNT = 4;
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Coarse-to-fine input of an IncrementalCanny: the 3x3 Gaussian filter and
+/// the gradients of the full resolution image are only computed near the
+/// coarse edges. The mask is kept for the current low threshold, and
+/// computed again when the threshold goes below the magnitude of the mask.
+class PyramidCanny
+{
+public:
+    PyramidCanny():
+        m_level_count(0),
+        m_mask_magnitude(0.0),
+        m_is_complete(false)
+    {}
+
+    /// Compute the mask of grey_image (CV_8UC1, or CV_32FC1 in [0, 1]) after
+    /// level_count reductions, then the gradients of canny in its tiles.
+    /// grey_image is kept, not copied.
+    void setImage(const cv::Mat& grey_image, int level_count, double low_threshold, IncrementalCanny& canny);
+
+    /// Compute the mask and the gradients of canny again if low_threshold
+    /// is below the magnitude of the mask. Return true if they were. Only
+    /// the buffers of this object and canny are written, so update() may
+    /// run in another thread, as long as that thread is the only one using
+    /// them until it is done. is_cancelled (if given) is checked between
+    /// the steps and before each tile of canny: once it returns true, the
+    /// update stops, and the next call computes the mask again whatever
+    /// its threshold.
+    bool update(double low_threshold,
+                IncrementalCanny& canny,
+                const std::function<bool()>& is_cancelled = std::function<bool()>());
+
+    /// Tiles of the mask (see findMaskTiles).
+    const std::vector<cv::Rect>& getTileSet() const { return m_tile_set; }
+
+    /// grey_image after the 3x3 Gaussian filter, computed in the tiles and
+    /// around them only, 0 elsewhere. Every update allocates a new image,
+    /// so a copy of the header taken before keeps the previous pixels.
+    const cv::Mat& getBlurredImage() const { return m_blurred_image; }
+
+private:
+    /// Return false if is_cancelled stopped the computation.
+    bool computeGradients(IncrementalCanny& canny, const std::function<bool()>& is_cancelled);
+
+    cv::Mat m_grey_image;
+    int m_level_count;
+    double m_mask_magnitude;
+
+    /// False if the last computation of the mask and gradients was cancelled
+    bool m_is_complete;
+
+    std::vector<cv::Rect> m_tile_set;
+
+    /// Tiles and the pixels around them read by IncrementalCanny, without
+    /// overlaps
+    std::vector<cv::Rect> m_region_set;
+
+    cv::Mat m_blurred_image;
+    cv::Mat m_blurred_8bit_image;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Threshold of the mask for the given low threshold of the hysteresis: a
+/// coarse pixel above the low threshold may belong to an edge.
+inline double getPyramidMaskMagnitude(double low_threshold);
+
+/// Mask (CV_8UC1, the size of grey_image) of the neighbourhood of the
+/// potential edges found after level_count reductions of grey_image
+/// (CV_8UC1, or CV_32FC1 in [0, 1]). The edges are dilated by 2^level_count + 2 pixels at full
+/// resolution, to cover their position error and the pixels needed by the
+/// non-maximum suppression.
+inline void computeCoarseEdgeMask(const cv::Mat& grey_image,
+                                  int level_count,
+                                  cv::Mat& mask,
+                                  double min_magnitude = PYRAMID_EDGE_MIN_MAGNITUDE);
+
+/// Rectangles that cover the tiles and border pixels around them, without
+/// overlaps, so that they can be filtered in parallel. The tiles must be
+/// those of findMaskTiles.
+inline void findTileBorderRegions(const std::vector<cv::Rect>& tile_set,
+                                  cv::Size image_size,
+                                  int border,
+                                  std::vector<cv::Rect>& region_set);
+
+/// Parse "--pyramid=N", the number of reductions of the image. Return false
+/// if the argument is not this option.
+inline bool parsePyramidOption(const std::string& argument, int& level_count);
+
+/// Coarse-to-fine version of canny.setImage(blurred_image): the gradients of
+/// blurred_image (grey_image after the 3x3 Gaussian filter) are only
+/// computed near the coarse edges of grey_image. With level_count = 0, the
+/// whole image is processed. The mask is returned in p_mask if given.
+inline void setPyramidImage(IncrementalCanny& canny,
+                            const cv::Mat& grey_image,
+                            const cv::Mat& blurred_image,
+                            int level_count,
+                            cv::Mat* p_mask = 0,
+                            double min_magnitude = PYRAMID_EDGE_MIN_MAGNITUDE);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//---------------------------------------------------------------------------------------------------------------------------
+inline void PyramidCanny::setImage(const cv::Mat& grey_image, int level_count, double low_threshold, IncrementalCanny& canny)
+//---------------------------------------------------------------------------------------------------------------------------
+{
+    m_grey_image = grey_image;
+    m_level_count = level_count;
+    m_mask_magnitude = getPyramidMaskMagnitude(low_threshold);
+    computeGradients(canny, std::function<bool()>());
+}
+
+
+//------------------------------------------------------------------------------
+inline bool PyramidCanny::update(double low_threshold,
+                                 IncrementalCanny& canny,
+                                 const std::function<bool()>& is_cancelled)
+//------------------------------------------------------------------------------
+{
+    // A higher threshold keeps the mask, which is only larger than needed,
+    // unless the last computation was cancelled
+    double mask_magnitude(getPyramidMaskMagnitude(low_threshold));
+    if (m_grey_image.empty() || (m_is_complete && mask_magnitude >= m_mask_magnitude))
+    {
+        return false;
+    }
+
+    m_mask_magnitude = mask_magnitude;
+    return computeGradients(canny, is_cancelled);
+}
+
+
+//------------------------------------------------------------------------------------------------------------
+inline bool PyramidCanny::computeGradients(IncrementalCanny& canny, const std::function<bool()>& is_cancelled)
+//------------------------------------------------------------------------------------------------------------
+{
+    // Until canny has the gradients of all the tiles
+    m_is_complete = false;
+
+    cv::Mat mask;
+    computeCoarseEdgeMask(m_grey_image, m_level_count, mask, m_mask_magnitude);
+    findMaskTiles(mask, m_tile_set);
+    findTileBorderRegions(m_tile_set, m_grey_image.size(), INCREMENTAL_CANNY_TILE_BORDER, m_region_set);
+    if (is_cancelled && is_cancelled())
+    {
+        return false;
+    }
+
+    // The Gaussian filter only in the regions, in a new image: the previous
+    // one may still be read through another header (see getBlurredImage)
+    m_blurred_image = cv::Mat(m_grey_image.size(), m_grey_image.type(), cv::Scalar(0));
+    gaussianBlur3x3(m_grey_image, m_blurred_image, m_region_set);
+    if (is_cancelled && is_cancelled())
+    {
+        return false;
+    }
+
+    // Canny works in 8 bits, only the float images are converted
+    m_blurred_8bit_image = m_blurred_image;
+    if (m_blurred_image.type() != CV_8UC1)
+    {
+        m_blurred_8bit_image = cv::Mat::zeros(m_grey_image.size(), CV_8UC1);
+        for (size_t i = 0; i < m_region_set.size(); ++i)
+        {
+            cv::Mat region(m_blurred_8bit_image, m_region_set[i]);
+            m_blurred_image(m_region_set[i]).convertTo(region, CV_8UC1, 255);
+        }
+    }
+
+    m_is_complete = canny.setImage(m_blurred_8bit_image, m_tile_set, is_cancelled);
+    return m_is_complete;
+}
+
+
+//---------------------------------------------------------
+inline double getPyramidMaskMagnitude(double low_threshold)
+//---------------------------------------------------------
+{
+    return std::max(0.0, std::min(PYRAMID_EDGE_MIN_MAGNITUDE, low_threshold));
+}
+
+
+//------------------------------------------------------------------------------
+inline void computeCoarseEdgeMask(const cv::Mat& grey_image,
+                                  int level_count,
+                                  cv::Mat& mask,
+                                  double min_magnitude)
+//------------------------------------------------------------------------------
+{
+    if (grey_image.type() != CV_8UC1 && grey_image.type() != CV_32FC1)
+    {
+        throw std::string("computeCoarseEdgeMask only supports CV_8UC1 and CV_32FC1 images.");
+    }
+
+    // Reduce the image, but keep at least 16 pixels in each direction
+    cv::Mat coarse_image(grey_image);
+    for (int level = 0; level < level_count && std::min(coarse_image.cols, coarse_image.rows) >= 32; ++level)
+    {
+        cv::pyrDown(coarse_image, coarse_image);
+    }
+
+    // Same pipeline as at full resolution, in 8 bits
+    if (coarse_image.type() != CV_8UC1)
+    {
+        coarse_image.convertTo(coarse_image, CV_8UC1, 255);
+    }
+
+    cv::Mat blurred_image;
+    gaussianBlur3x3(coarse_image, blurred_image);
+
+    IncrementalCanny coarse_canny(blurred_image);
+    cv::Mat coarse_mask;
+    cv::compare(coarse_canny.getSuppressedMagnitude(), min_magnitude, coarse_mask, cv::CMP_GE);
+
+    // Back to full resolution, then dilate
+    int factor((grey_image.cols + coarse_image.cols - 1) / coarse_image.cols);
+    int radius(factor + 2);
+
+    cv::resize(coarse_mask, mask, grey_image.size(), 0, 0, cv::INTER_NEAREST);
+    cv::dilate(mask, mask, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(2 * radius + 1, 2 * radius + 1)));
+}
+
+
+//------------------------------------------------------------------------------
+inline void setPyramidImage(IncrementalCanny& canny,
+                            const cv::Mat& grey_image,
+                            const cv::Mat& blurred_image,
+                            int level_count,
+                            cv::Mat* p_mask,
+                            double min_magnitude)
+//------------------------------------------------------------------------------
+{
+    if (level_count <= 0)
+    {
+        canny.setImage(blurred_image);
+
+        if (p_mask)
+        {
+            p_mask->create(grey_image.size(), CV_8UC1);
+            p_mask->setTo(cv::Scalar(255));
+        }
+        return;
+    }
+
+    cv::Mat mask;
+    computeCoarseEdgeMask(grey_image, level_count, mask, min_magnitude);
+    canny.setImage(blurred_image, mask);
+
+    if (p_mask)
+    {
+        *p_mask = mask;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void findTileBorderRegions(const std::vector<cv::Rect>& tile_set,
+                                  cv::Size image_size,
+                                  int border,
+                                  std::vector<cv::Rect>& region_set)
+//------------------------------------------------------------------------------
+{
+    const int tile_size(INCREMENTAL_CANNY_TILE_SIZE);
+    int tile_count_x((image_size.width + tile_size - 1) / tile_size);
+    int tile_count_y((image_size.height + tile_size - 1) / tile_size);
+
+    // The runs of tiles are one tile apart at least, their borders must not
+    // meet
+    if (border < 0 || 2 * border > tile_size)
+    {
+        throw std::string("findTileBorderRegions: the border must be between 0 and half the size of the tiles.");
+    }
+
+    // Tiles in the mask, with an empty row of tiles above and below
+    std::vector<unsigned char> active((tile_count_y + 2) * tile_count_x, 0);
+    for (size_t i = 0; i < tile_set.size(); ++i)
+    {
+        active[(tile_set[i].y / tile_size + 1) * tile_count_x + tile_set[i].x / tile_size] = 1;
+    }
+
+    region_set.clear();
+    std::vector<unsigned char> needed(tile_count_x);
+    for (int tile_y = 0; tile_y < tile_count_y; ++tile_y)
+    {
+        // The first rows of a row of tiles are also needed by the tiles
+        // above, and the last ones by the tiles below. The segments of rows
+        // start at these limits.
+        int y0(tile_y * tile_size);
+        int y1(std::min(y0 + tile_size, image_size.height));
+        int limit_set[4] = {y0, std::min(y0 + border, y1), std::max(y1 - border, y0), y1};
+        std::sort(limit_set, limit_set + 4);
+
+        for (int segment = 0; segment < 3; ++segment)
+        {
+            int first_y(limit_set[segment]);
+            int last_y(limit_set[segment + 1]);
+            if (first_y == last_y)
+            {
+                continue;
+            }
+
+            const unsigned char* p_above(&active[tile_y * tile_count_x]);
+            const unsigned char* p_current(&active[(tile_y + 1) * tile_count_x]);
+            const unsigned char* p_below(&active[(tile_y + 2) * tile_count_x]);
+            for (int tile_x = 0; tile_x < tile_count_x; ++tile_x)
+            {
+                needed[tile_x] = p_current[tile_x] ||
+                    (first_y < y0 + border && p_above[tile_x]) ||
+                    (last_y > y1 - border && p_below[tile_x]);
+            }
+
+            // One region per run of tiles, with the border on the left and
+            // on the right
+            for (int tile_x = 0; tile_x < tile_count_x; ++tile_x)
+            {
+                if (!needed[tile_x])
+                {
+                    continue;
+                }
+
+                int first_tile_x(tile_x);
+                while (tile_x + 1 < tile_count_x && needed[tile_x + 1])
+                {
+                    ++tile_x;
+                }
+
+                int first_x(std::max(first_tile_x * tile_size - border, 0));
+                int last_x(std::min((tile_x + 1) * tile_size + border, image_size.width));
+                region_set.push_back(cv::Rect(first_x, first_y, last_x - first_x, last_y - first_y));
+            }
+        }
+    }
+}
+
+
+//---------------------------------------------------------------------------
+inline bool parsePyramidOption(const std::string& argument, int& level_count)
+//---------------------------------------------------------------------------
+{
+    if (argument.find("--pyramid=") != 0)
+    {
+        return false;
+    }
+
+    level_count = atoi(argument.substr(std::string("--pyramid=").size()).c_str());
+
+    if (level_count < 0 || level_count > PYRAMID_EDGE_MAX_LEVEL_COUNT)
+    {
+        throw std::string("The number of pyramid levels must be between 0 and 4.");
+    }
+
+    return true;
+}
+
+
+#endif // PYRAMID_EDGES_H
@@ -0,0 +1,210 @@
+/**
+********************************************************************************
+*
+*   @file       recursiveGaussian.h
+*
+*   @brief      A recursive (IIR) approximation of the Gaussian filter whose
+*               cost per pixel does not depend on sigma. It implements the
+*               third-order filter of Young and van Vliet ("Recursive
+*               implementation of the Gaussian filter", Signal Processing,
+*               1995): a causal pass followed by an anti-causal pass along
+*               each axis.
+*
+*               The vertical passes run down the image one row at a time, so
+*               the inner loop is over contiguous pixels and is vectorised by
+*               the compiler. The image is split in blocks of columns that
+*               are processed in parallel. The horizontal passes reuse the
+*               same code on the transposed image.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef RECURSIVE_GAUSSIAN_H
+#define RECURSIVE_GAUSSIAN_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <cmath>     // Header for sqrt
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Coefficients of the recursive filter for a given sigma.
+struct RecursiveGaussianCoefficients
+{
+    explicit RecursiveGaussianCoefficients(double sigma)
+    {
+        // Equation 11b of Young and van Vliet
+        double q;
+        if (sigma >= 2.5)
+        {
+            q = 0.98711 * sigma - 0.96330;
+        }
+        else
+        {
+            q = 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+        }
+
+        // Equation 8c
+        double b0 = 1.57825 + 2.44413 * q + 1.4281 * q * q + 0.422205 * q * q * q;
+        double b1 = 2.44413 * q + 2.85619 * q * q + 1.26661 * q * q * q;
+        double b2 = -(1.4281 * q * q + 1.26661 * q * q * q);
+        double b3 = 0.422205 * q * q * q;
+
+        // Normalised coefficients, B + a1 + a2 + a3 = 1
+        a1 = float(b1 / b0);
+        a2 = float(b2 / b0);
+        a3 = float(b3 / b0);
+        B  = float(1.0 - (b1 + b2 + b3) / b0);
+    }
+
+    float B, a1, a2, a3;
+};
+
+
+/// Run the causal and anti-causal passes down a block of columns.
+class RecursiveGaussianBody : public cv::ParallelLoopBody
+{
+public:
+    RecursiveGaussianBody(cv::Mat& image,
+                          const RecursiveGaussianCoefficients& coefficients,
+                          int block_width):
+        m_image(image),
+        m_coefficients(coefficients),
+        m_block_width(block_width)
+    {}
+
+    virtual void operator()(const cv::Range& range) const
+    {
+        int width(m_image.cols * m_image.channels());
+
+        for (int block = range.start; block < range.end; ++block)
+        {
+            int first(block * m_block_width);
+            int last(std::min(width, first + m_block_width));
+            processBlock(first, last);
+        }
+    }
+
+private:
+    void processBlock(int first, int last) const;
+
+    cv::Mat& m_image;
+    const RecursiveGaussianCoefficients& m_coefficients;
+    int m_block_width;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Gaussian filter of an image of any depth and number of channels using the
+/// recursive approximation. sigma must be at least 0.5. The border is
+/// replicated. The output has the same type as the input.
+inline void recursiveGaussianBlur(const cv::Mat& src, cv::Mat& dst, double sigma);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-------------------------------------------------------------------------------
+inline void recursiveGaussianBlur(const cv::Mat& src, cv::Mat& dst, double sigma)
+//-------------------------------------------------------------------------------
+{
+    if (sigma < 0.5)
+    {
+        throw std::string("The recursive Gaussian filter requires sigma >= 0.5.");
+    }
+
+    RecursiveGaussianCoefficients coefficients(sigma);
+
+    // Work in float, in a buffer that does not alias the input
+    cv::Mat buffer;
+    src.convertTo(buffer, CV_32F);
+    if (buffer.data == src.data)
+    {
+        buffer = buffer.clone();
+    }
+
+    // 256 floats per block: the three previous rows of a block stay in cache
+    const int block_width(256);
+
+    for (int axis = 0; axis < 2; ++axis)
+    {
+        int width(buffer.cols * buffer.channels());
+        int block_count((width + block_width - 1) / block_width);
+
+        cv::parallel_for_(cv::Range(0, block_count),
+            RecursiveGaussianBody(buffer, coefficients, block_width));
+
+        // The horizontal passes are vertical passes on the transposed image
+        cv::Mat transposed;
+        cv::transpose(buffer, transposed);
+        buffer = transposed;
+    }
+
+    buffer.convertTo(dst, src.type());
+}
+
+
+//------------------------------------------------------------------------
+inline void RecursiveGaussianBody::processBlock(int first, int last) const
+//------------------------------------------------------------------------
+{
+    const float B(m_coefficients.B);
+    const float a1(m_coefficients.a1);
+    const float a2(m_coefficients.a2);
+    const float a3(m_coefficients.a3);
+    int rows(m_image.rows);
+
+    // Causal pass. Before the first row, the filter is in the steady state
+    // of a constant signal equal to the first row (replicated border), i.e.
+    // the rows before the first one hold the value of the first row.
+    for (int y = 1; y < rows; ++y)
+    {
+        float* p_current = m_image.ptr<float>(y);
+        const float* p_1 = m_image.ptr<float>(y - 1);
+        const float* p_2 = m_image.ptr<float>(std::max(y - 2, 0));
+        const float* p_3 = m_image.ptr<float>(std::max(y - 3, 0));
+
+        for (int i = first; i < last; ++i)
+        {
+            p_current[i] = B * p_current[i] + a1 * p_1[i] + a2 * p_2[i] + a3 * p_3[i];
+        }
+    }
+
+    // Anti-causal pass, in the steady state of the last row after the image
+    for (int y = rows - 2; y >= 0; --y)
+    {
+        float* p_current = m_image.ptr<float>(y);
+        const float* p_1 = m_image.ptr<float>(y + 1);
+        const float* p_2 = m_image.ptr<float>(std::min(y + 2, rows - 1));
+        const float* p_3 = m_image.ptr<float>(std::min(y + 3, rows - 1));
+
+        for (int i = first; i < last; ++i)
+        {
+            p_current[i] = B * p_current[i] + a1 * p_1[i] + a2 * p_2[i] + a3 * p_3[i];
+        }
+    }
+}
+
+
+#endif // RECURSIVE_GAUSSIAN_H
@@ -0,0 +1,566 @@
+/**
+********************************************************************************
+*
+*   @file       scharrMagnitude.h
+*
+*   @brief      Gradient magnitude 0.5 * |Scharr_x| + 0.5 * |Scharr_y| of a
+*               greyscale image in a single fused pass, optionally
+*               preceded by the 3x3 Gaussian filter (sigma 0.5) of the edge
+*               detectors, and optionally with the direction of the gradient
+*               quantised to 4 values for the non-maximum suppression.
+*
+*               The image is processed in tiles of 64 rows by 512 columns,
+*               in parallel. Within a tile, the blurred rows are kept in a
+*               ring buffer of 3 rows, so each input row is read once, and
+*               no full-size intermediate image is created. The loops over
+*               the columns have no dependency between iterations and are
+*               vectorised by the compiler. The border is BORDER_REFLECT_101
+*               and, in float, the arithmetic is done in the same order as in
+*               smallKernelGaussianBlur followed by smallKernelScharr, so the
+*               results match the separate filters.
+*
+*               The kernels are templates on a precision policy
+*               (precisionPolicy.h): 8-bit images with integer arithmetic and
+*               CV_16SC1 magnitudes, or float images and magnitudes. The
+*               non-template functions choose the policy from the type of the
+*               input. gaussianBlur3x3 is the same Gaussian filter on its own,
+*               for the pipelines that need the blurred image (e.g. Canny).
+*               Both can be restricted to a set of regions of the image, e.g.
+*               the tiles kept by a coarse-to-fine detector (pyramidEdges.h).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef SCHARR_MAGNITUDE_H
+#define SCHARR_MAGNITUDE_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min and std::max
+#include <cmath>     // Header for abs
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the row buffers
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "precisionPolicy.h" // Fixed point or float arithmetic
+
+
+//******************************************************************************
+//    Constant variables
+//******************************************************************************
+
+/// Quantised directions of the gradient (the y-axis points down).
+enum GradientDirection
+{
+    GRADIENT_0   = 0, ///< Horizontal gradient, vertical edge
+    GRADIENT_45  = 1, ///< Along the diagonal (1, 1)
+    GRADIENT_90  = 2, ///< Vertical gradient, horizontal edge
+    GRADIENT_135 = 3  ///< Along the diagonal (1, -1)
+};
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Rows of an image, optionally blurred by the 3x3 Gaussian filter.
+template<typename Precision> class Gaussian3x3Rows
+{
+public:
+    typedef typename Precision::Pixel Pixel;
+    typedef typename Precision::Accumulator Accumulator;
+
+    Gaussian3x3Rows(const cv::Mat& src, bool gaussian):
+        m_src(src),
+        m_gaussian(gaussian)
+    {
+        Precision::getGaussianKernel(m_kernel);
+    }
+
+    /// Row y of the (blurred) image, for the columns x0 - 1 to x1 + 1. The
+    /// buffers have x1 - x0 + 4 elements and are indexed from x0 - 2.
+    void computeRow(int y, int x0, int x1, Accumulator* p_vertical, Accumulator* p_row) const;
+
+private:
+    int reflect(int i, int size) const
+    {
+        return cv::borderInterpolate(i, size, cv::BORDER_REFLECT_101);
+    }
+
+    const cv::Mat& m_src;
+    bool m_gaussian;
+    Accumulator m_kernel[3];
+};
+
+
+/// Compute the magnitude (and the direction) for a set of tiles, either a
+/// grid of tiles or the regions given in p_region_set.
+template<typename Precision> class ScharrMagnitudeBody : public cv::ParallelLoopBody
+{
+public:
+    typedef typename Precision::Accumulator Accumulator;
+    typedef typename Precision::Magnitude Magnitude;
+
+    ScharrMagnitudeBody(const cv::Mat& src,
+                        cv::Mat& magnitude,
+                        cv::Mat* p_direction,
+                        bool gaussian,
+                        int tile_rows,
+                        int tile_cols,
+                        const std::vector<cv::Rect>* p_region_set = 0):
+        m_rows(src, gaussian),
+        m_src(src),
+        m_magnitude(magnitude),
+        m_p_direction(p_direction),
+        m_tile_rows(tile_rows),
+        m_tile_cols(tile_cols),
+        m_tile_count_x((src.cols + tile_cols - 1) / tile_cols),
+        m_p_region_set(p_region_set)
+    {}
+
+    virtual void operator()(const cv::Range& range) const
+    {
+        for (int tile = range.start; tile < range.end; ++tile)
+        {
+            if (m_p_region_set)
+            {
+                const cv::Rect& region((*m_p_region_set)[tile]);
+                processTile(region.x, region.x + region.width, region.y, region.y + region.height);
+                continue;
+            }
+
+            int x0((tile % m_tile_count_x) * m_tile_cols);
+            int y0((tile / m_tile_count_x) * m_tile_rows);
+
+            processTile(x0, std::min(x0 + m_tile_cols, m_src.cols),
+                        y0, std::min(y0 + m_tile_rows, m_src.rows));
+        }
+    }
+
+private:
+    void processTile(int x0, int x1, int y0, int y1) const;
+
+    Gaussian3x3Rows<Precision> m_rows;
+    const cv::Mat& m_src;
+    cv::Mat& m_magnitude;
+    cv::Mat* m_p_direction;
+    int m_tile_rows;
+    int m_tile_cols;
+    int m_tile_count_x;
+    const std::vector<cv::Rect>* m_p_region_set;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Gradient magnitude of a Precision::PIXEL_TYPE image, after the 3x3
+/// Gaussian filter if gaussian is true. The magnitude is a
+/// Precision::MAGNITUDE_TYPE image. If p_direction is given, it receives the
+/// quantised direction of the gradient (GradientDirection) as a CV_8UC1 image.
+template<typename Precision> void scharrMagnitude(const cv::Mat& src,
+                                                  cv::Mat& magnitude,
+                                                  bool gaussian = false,
+                                                  cv::Mat* p_direction = 0);
+
+/// Same for a CV_8UC1 (fixed point, CV_16SC1 magnitude) or a CV_32FC1 image.
+inline void scharrMagnitude(const cv::Mat& src,
+                            cv::Mat& magnitude,
+                            bool gaussian = false,
+                            cv::Mat* p_direction = 0);
+
+/// Same, but only in the regions of region_set, which must not overlap: the
+/// magnitude (and the direction) are 0 outside the regions.
+inline void scharrMagnitude(const cv::Mat& src,
+                            cv::Mat& magnitude,
+                            const std::vector<cv::Rect>& region_set,
+                            bool gaussian = false,
+                            cv::Mat* p_direction = 0);
+
+/// 3x3 Gaussian filter (sigma 0.5) of a Precision::PIXEL_TYPE image, exactly
+/// as folded in scharrMagnitude.
+template<typename Precision> void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst);
+
+/// Same for a CV_8UC1 or a CV_32FC1 image.
+inline void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst);
+
+/// Same, but only the pixels of the regions of region_set are written. The
+/// regions must not overlap, and dst must be different from src. The
+/// filter reads the pixels around the regions, as for the whole image.
+template<typename Precision> void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst, const std::vector<cv::Rect>& region_set);
+
+/// Same for a CV_8UC1 or a CV_32FC1 image.
+inline void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst, const std::vector<cv::Rect>& region_set);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//--------------------------------------------------------------------------------------------
+template<typename Precision> void Gaussian3x3Rows<Precision>::computeRow(int y,
+                                                                         int x0,
+                                                                         int x1,
+                                                                         Accumulator* p_vertical,
+                                                                         Accumulator* p_row) const
+//--------------------------------------------------------------------------------------------
+{
+    // p_vertical and p_row are indexed from x0 - 2
+    const int width(m_src.cols);
+    const int first(std::max(x0 - 2, 0));
+    const int last(std::min(x1 + 2, width));
+    y = reflect(y, m_src.rows);
+
+    if (!m_gaussian)
+    {
+        const Pixel* p_input = m_src.ptr<Pixel>(y);
+        for (int x = first; x < last; ++x)
+        {
+            p_row[x - x0 + 2] = Accumulator(p_input[x]);
+        }
+    }
+    else
+    {
+        // Vertical pass, only for the columns inside the image
+        const Pixel* p_0 = m_src.ptr<Pixel>(reflect(y - 1, m_src.rows));
+        const Pixel* p_1 = m_src.ptr<Pixel>(y);
+        const Pixel* p_2 = m_src.ptr<Pixel>(reflect(y + 1, m_src.rows));
+        const Accumulator k0(m_kernel[0]), k1(m_kernel[1]), k2(m_kernel[2]);
+
+        for (int x = first; x < last; ++x)
+        {
+            p_vertical[x - x0 + 2] = k0 * p_0[x] + k1 * p_1[x] + k2 * p_2[x];
+        }
+
+        // Columns outside the image
+        for (int x = x0 - 2; x < first; ++x)
+        {
+            p_vertical[x - x0 + 2] = p_vertical[reflect(x, width) - x0 + 2];
+        }
+        for (int x = last; x < x1 + 2; ++x)
+        {
+            p_vertical[x - x0 + 2] = p_vertical[reflect(x, width) - x0 + 2];
+        }
+
+        // Horizontal pass
+        for (int x = std::max(x0 - 1, 0); x < std::min(x1 + 1, width); ++x)
+        {
+            const Accumulator* p_v = p_vertical + x - x0 + 2;
+            p_row[x - x0 + 2] = Precision::normaliseBlur(k0 * p_v[-1] + k1 * p_v[0] + k2 * p_v[1]);
+        }
+    }
+
+    // Columns outside the image are copies of the ones inside
+    for (int x = x0 - 1; x < 0; ++x)
+    {
+        p_row[x - x0 + 2] = p_row[reflect(x, width) - x0 + 2];
+    }
+    for (int x = width; x < x1 + 1; ++x)
+    {
+        p_row[x - x0 + 2] = p_row[reflect(x, width) - x0 + 2];
+    }
+}
+
+
+//-----------------------------------------------------------------------------------------------------------------
+template<typename Precision> void ScharrMagnitudeBody<Precision>::processTile(int x0, int x1, int y0, int y1) const
+//-----------------------------------------------------------------------------------------------------------------
+{
+    const int size(x1 - x0 + 4);
+
+    // Ring buffer of 3 rows of the (blurred) image, and the vertical passes
+    std::vector<Accumulator> buffer(6 * size);
+    Accumulator* p_ring[3] = {&buffer[0], &buffer[size], &buffer[2 * size]};
+    Accumulator* p_vertical   = &buffer[3 * size];
+    Accumulator* p_smoothing  = &buffer[4 * size];
+    Accumulator* p_derivative = &buffer[5 * size];
+
+    // Rows y0 - 1 and y0
+    m_rows.computeRow(y0 - 1, x0, x1, p_vertical, p_ring[(y0 + 2) % 3]);
+    m_rows.computeRow(y0,     x0, x1, p_vertical, p_ring[y0 % 3]);
+
+    for (int y = y0; y < y1; ++y)
+    {
+        m_rows.computeRow(y + 1, x0, x1, p_vertical, p_ring[(y + 1) % 3]);
+
+        const Accumulator* p_a = p_ring[(y + 2) % 3];
+        const Accumulator* p_b = p_ring[y % 3];
+        const Accumulator* p_c = p_ring[(y + 1) % 3];
+
+        // Vertical passes of Scharr X (smoothing) and Scharr Y (derivative)
+        for (int i = 1; i < size - 1; ++i)
+        {
+            p_smoothing[i]  = 3 * p_a[i] + 10 * p_b[i] + 3 * p_c[i];
+            p_derivative[i] = p_c[i] - p_a[i];
+        }
+
+        // Horizontal passes and magnitude
+        Magnitude* p_magnitude = m_magnitude.ptr<Magnitude>(y) + x0;
+        for (int i = 2; i < size - 2; ++i)
+        {
+            Accumulator gx(p_smoothing[i + 1] - p_smoothing[i - 1]);
+            Accumulator gy(3 * p_derivative[i - 1] + 10 * p_derivative[i] + 3 * p_derivative[i + 1]);
+            p_magnitude[i - 2] = Precision::getMagnitude(gx, gy);
+        }
+
+        if (m_p_direction)
+        {
+            // tan(22.5 degrees) and tan(67.5 degrees)
+            const float tan_22_5(0.41421356f);
+            const float tan_67_5(2.41421356f);
+
+            unsigned char* p_direction = m_p_direction->ptr<unsigned char>(y) + x0;
+            for (int i = 2; i < size - 2; ++i)
+            {
+                Accumulator gx(p_smoothing[i + 1] - p_smoothing[i - 1]);
+                Accumulator gy(3 * p_derivative[i - 1] + 10 * p_derivative[i] + 3 * p_derivative[i + 1]);
+                float abs_gx(std::abs(gx));
+                float abs_gy(std::abs(gy));
+
+                if (abs_gy <= tan_22_5 * abs_gx)
+                {
+                    p_direction[i - 2] = GRADIENT_0;
+                }
+                else if (abs_gy >= tan_67_5 * abs_gx)
+                {
+                    p_direction[i - 2] = GRADIENT_90;
+                }
+                else
+                {
+                    p_direction[i - 2] = (gx > 0) == (gy > 0) ? GRADIENT_45 : GRADIENT_135;
+                }
+            }
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+template<typename Precision> void scharrMagnitude(const cv::Mat& src,
+                                                  cv::Mat& magnitude,
+                                                  bool gaussian,
+                                                  cv::Mat* p_direction)
+//------------------------------------------------------------------------------
+{
+    if (src.type() != Precision::PIXEL_TYPE)
+    {
+        throw std::string("scharrMagnitude: the type of the image does not match the precision.");
+    }
+
+    // The output must not alias the input
+    cv::Mat input = src;
+    if (src.data == magnitude.data)
+    {
+        input = src.clone();
+    }
+
+    magnitude.create(src.size(), Precision::MAGNITUDE_TYPE);
+    if (p_direction)
+    {
+        p_direction->create(src.size(), CV_8UC1);
+    }
+
+    // A tile of 512 columns fits in the L1 cache with its 6 row buffers
+    const int tile_rows(64);
+    const int tile_cols(512);
+    int tile_count(((src.rows + tile_rows - 1) / tile_rows) * ((src.cols + tile_cols - 1) / tile_cols));
+
+    cv::parallel_for_(cv::Range(0, tile_count),
+        ScharrMagnitudeBody<Precision>(input, magnitude, p_direction, gaussian, tile_rows, tile_cols));
+}
+
+
+//------------------------------------------------------------------------------
+inline void scharrMagnitude(const cv::Mat& src,
+                            cv::Mat& magnitude,
+                            bool gaussian,
+                            cv::Mat* p_direction)
+//------------------------------------------------------------------------------
+{
+    if (src.type() == CV_8UC1)
+    {
+        scharrMagnitude<FixedPointPrecision>(src, magnitude, gaussian, p_direction);
+    }
+    else if (src.type() == CV_32FC1)
+    {
+        scharrMagnitude<FloatPrecision>(src, magnitude, gaussian, p_direction);
+    }
+    else
+    {
+        throw std::string("scharrMagnitude only supports CV_8UC1 and CV_32FC1 images.");
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void scharrMagnitude(const cv::Mat& src,
+                            cv::Mat& magnitude,
+                            const std::vector<cv::Rect>& region_set,
+                            bool gaussian,
+                            cv::Mat* p_direction)
+//------------------------------------------------------------------------------
+{
+    if (src.type() != CV_8UC1 && src.type() != CV_32FC1)
+    {
+        throw std::string("scharrMagnitude only supports CV_8UC1 and CV_32FC1 images.");
+    }
+
+    if (src.data == magnitude.data)
+    {
+        throw std::string("scharrMagnitude: the output of the regions must not alias the input.");
+    }
+
+    bool fixed_point(src.type() == CV_8UC1);
+    magnitude.create(src.size(), fixed_point ? int(FixedPointPrecision::MAGNITUDE_TYPE) : int(FloatPrecision::MAGNITUDE_TYPE));
+    magnitude.setTo(cv::Scalar(0));
+    if (p_direction)
+    {
+        p_direction->create(src.size(), CV_8UC1);
+        p_direction->setTo(cv::Scalar(GRADIENT_0));
+    }
+
+    // The regions are the tiles
+    cv::Range range(0, int(region_set.size()));
+    if (fixed_point)
+    {
+        cv::parallel_for_(range, ScharrMagnitudeBody<FixedPointPrecision>(src, magnitude, p_direction, gaussian, 0, 1, &region_set));
+    }
+    else
+    {
+        cv::parallel_for_(range, ScharrMagnitudeBody<FloatPrecision>(src, magnitude, p_direction, gaussian, 0, 1, &region_set));
+    }
+}
+
+
+//---------------------------------------------------------------------------------
+template<typename Precision> void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst)
+//---------------------------------------------------------------------------------
+{
+    typedef typename Precision::Pixel Pixel;
+    typedef typename Precision::Accumulator Accumulator;
+
+    if (src.type() != Precision::PIXEL_TYPE)
+    {
+        throw std::string("gaussianBlur3x3: the type of the image does not match the precision.");
+    }
+
+    // The output must not alias the input
+    cv::Mat input = src;
+    if (src.data == dst.data)
+    {
+        input = src.clone();
+    }
+
+    dst.create(src.size(), Precision::PIXEL_TYPE);
+    Gaussian3x3Rows<Precision> rows(input, true);
+
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range)
+    {
+        std::vector<Accumulator> buffer(2 * (src.cols + 4));
+        Accumulator* p_vertical = &buffer[0];
+        Accumulator* p_row      = &buffer[src.cols + 4];
+
+        for (int y = range.start; y < range.end; ++y)
+        {
+            rows.computeRow(y, 0, src.cols, p_vertical, p_row);
+
+            Pixel* p_output = dst.ptr<Pixel>(y);
+            for (int x = 0; x < src.cols; ++x)
+            {
+                p_output[x] = Pixel(p_row[x + 2]);
+            }
+        }
+    });
+}
+
+
+//-----------------------------------------------------------
+inline void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst)
+//-----------------------------------------------------------
+{
+    if (src.type() == CV_8UC1)
+    {
+        gaussianBlur3x3<FixedPointPrecision>(src, dst);
+    }
+    else if (src.type() == CV_32FC1)
+    {
+        gaussianBlur3x3<FloatPrecision>(src, dst);
+    }
+    else
+    {
+        throw std::string("gaussianBlur3x3 only supports CV_8UC1 and CV_32FC1 images.");
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------------
+template<typename Precision> void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst, const std::vector<cv::Rect>& region_set)
+//--------------------------------------------------------------------------------------------------------------------------
+{
+    typedef typename Precision::Pixel Pixel;
+    typedef typename Precision::Accumulator Accumulator;
+
+    dst.create(src.size(), Precision::PIXEL_TYPE);
+    Gaussian3x3Rows<Precision> rows(src, true);
+
+    cv::parallel_for_(cv::Range(0, int(region_set.size())), [&](const cv::Range& range)
+    {
+        for (int i = range.start; i < range.end; ++i)
+        {
+            const cv::Rect& region(region_set[i]);
+            std::vector<Accumulator> buffer(2 * (region.width + 4));
+            Accumulator* p_vertical = &buffer[0];
+            Accumulator* p_row      = &buffer[region.width + 4];
+
+            for (int y = region.y; y < region.y + region.height; ++y)
+            {
+                rows.computeRow(y, region.x, region.x + region.width, p_vertical, p_row);
+
+                Pixel* p_output = dst.ptr<Pixel>(y) + region.x;
+                for (int x = 0; x < region.width; ++x)
+                {
+                    p_output[x] = Pixel(p_row[x + 2]);
+                }
+            }
+        }
+    });
+}
+
+
+//----------------------------------------------------------------------------------------------------
+inline void gaussianBlur3x3(const cv::Mat& src, cv::Mat& dst, const std::vector<cv::Rect>& region_set)
+//----------------------------------------------------------------------------------------------------
+{
+    if (src.data == dst.data)
+    {
+        throw std::string("gaussianBlur3x3: the output of the regions must not alias the input.");
+    }
+
+    if (src.type() == CV_8UC1)
+    {
+        gaussianBlur3x3<FixedPointPrecision>(src, dst, region_set);
+    }
+    else if (src.type() == CV_32FC1)
+    {
+        gaussianBlur3x3<FloatPrecision>(src, dst, region_set);
+    }
+    else
+    {
+        throw std::string("gaussianBlur3x3 only supports CV_8UC1 and CV_32FC1 images.");
+    }
+}
+
+
+#endif // SCHARR_MAGNITUDE_H
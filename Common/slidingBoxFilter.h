@@ -0,0 +1,257 @@
+/**
+********************************************************************************
+*
+*   @file       slidingBoxFilter.h
+*
+*   @brief      A mean (box) filter whose cost per pixel does not depend on
+*               the radius of the kernel. Column sums are kept for the
+*               current row and slid down the image; a running sum is then
+*               slid along each row. Several radii are computed in the same
+*               pass over the input, which is split in horizontal strips
+*               that are processed in parallel.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef SLIDING_BOX_FILTER_H
+#define SLIDING_BOX_FILTER_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::max_element
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the sums
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Filter a strip of rows for every radius. SumType accumulates PixelType
+/// without overflow or drift (int for 8-bit, double for float).
+template<typename PixelType, typename SumType>
+class SlidingBoxFilterBody : public cv::ParallelLoopBody
+{
+public:
+    SlidingBoxFilterBody(const cv::Mat& src,
+                         std::vector<cv::Mat>& dst,
+                         const std::vector<int>& radius_set,
+                         int strip_count):
+        m_src(src),
+        m_dst(dst),
+        m_radius_set(radius_set),
+        m_strip_count(strip_count)
+    {
+        // Border of the rows, same as cv::blur (BORDER_REFLECT_101)
+        m_max_radius = *std::max_element(radius_set.begin(), radius_set.end());
+        m_column_map.resize(src.cols + 2 * m_max_radius + 2);
+        for (int x = -m_max_radius - 1; x <= src.cols + m_max_radius; ++x)
+        {
+            m_column_map[x + m_max_radius + 1] = cv::borderInterpolate(x, src.cols, cv::BORDER_REFLECT_101);
+        }
+    }
+
+    virtual void operator()(const cv::Range& range) const
+    {
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            processStrip(strip);
+        }
+    }
+
+private:
+    void processStrip(int strip) const;
+
+    int mapColumn(int x) const
+    {
+        return m_column_map[x + m_max_radius + 1];
+    }
+
+    int mapRow(int y) const
+    {
+        return cv::borderInterpolate(y, m_src.rows, cv::BORDER_REFLECT_101);
+    }
+
+    const cv::Mat& m_src;
+    std::vector<cv::Mat>& m_dst;
+    const std::vector<int>& m_radius_set;
+    int m_strip_count;
+    int m_max_radius;
+    std::vector<int> m_column_map;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Mean filter of a CV_8U or CV_32F image (any number of channels) for
+/// every radius in radius_set, using square kernels of size 2 * radius + 1.
+/// The border is the same as in cv::blur. dst[i] is filtered with radius_set[i].
+inline void slidingBoxFilter(const cv::Mat& src,
+                             std::vector<cv::Mat>& dst,
+                             const std::vector<int>& radius_set);
+
+/// Mean filter of a CV_8U or CV_32F image for a single radius.
+inline void slidingBoxFilter(const cv::Mat& src, cv::Mat& dst, int radius);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------------------------------------
+inline void slidingBoxFilter(const cv::Mat& src,
+                             std::vector<cv::Mat>& dst,
+                             const std::vector<int>& radius_set)
+//-----------------------------------------------------------
+{
+    if (src.depth() != CV_8U && src.depth() != CV_32F)
+    {
+        throw std::string("The sliding box filter only supports 8-bit and float images.");
+    }
+
+    if (radius_set.empty())
+    {
+        throw std::string("No radius given to the sliding box filter.");
+    }
+
+    for (std::vector<int>::const_iterator ite = radius_set.begin(); ite != radius_set.end(); ++ite)
+    {
+        if (*ite < 0)
+        {
+            throw std::string("The radius of the mean filter cannot be negative.");
+        }
+    }
+
+    // Filtering in place is not possible
+    cv::Mat input = src;
+    dst.resize(radius_set.size());
+    for (std::size_t i = 0; i < dst.size(); ++i)
+    {
+        if (dst[i].data == src.data)
+        {
+            input = src.clone();
+            dst[i].release();
+        }
+    }
+
+    for (std::size_t i = 0; i < dst.size(); ++i)
+    {
+        dst[i].create(src.size(), src.type());
+    }
+
+    // One strip per thread, each strip has its own column sums
+    int strip_count(std::max(1, std::min(cv::getNumThreads(), input.rows)));
+
+    if (src.depth() == CV_8U)
+    {
+        cv::parallel_for_(cv::Range(0, strip_count),
+            SlidingBoxFilterBody<unsigned char, int>(input, dst, radius_set, strip_count));
+    }
+    else
+    {
+        cv::parallel_for_(cv::Range(0, strip_count),
+            SlidingBoxFilterBody<float, double>(input, dst, radius_set, strip_count));
+    }
+}
+
+
+//------------------------------------------------------------------------
+inline void slidingBoxFilter(const cv::Mat& src, cv::Mat& dst, int radius)
+//------------------------------------------------------------------------
+{
+    std::vector<cv::Mat> dst_set(1, dst);
+    slidingBoxFilter(src, dst_set, std::vector<int>(1, radius));
+    dst = dst_set[0];
+}
+
+
+//-------------------------------------------------------------------------
+template<typename PixelType, typename SumType>
+void SlidingBoxFilterBody<PixelType, SumType>::processStrip(int strip) const
+//-------------------------------------------------------------------------
+{
+    int first_row(m_src.rows * strip / m_strip_count);
+    int last_row(m_src.rows * (strip + 1) / m_strip_count);
+
+    if (first_row >= last_row)
+    {
+        return;
+    }
+
+    int channels(m_src.channels());
+    int width(m_src.cols * channels);
+
+    // Vertical sums of every column, one set per radius
+    std::vector<std::vector<SumType> > column_sum_set(m_radius_set.size(),
+                                                      std::vector<SumType>(width, SumType(0)));
+
+    // Every radius is updated from the same input rows, so that the image
+    // is only read once whatever the number of radii
+    for (int y = first_row; y < last_row; ++y)
+    {
+        for (std::size_t k = 0; k < m_radius_set.size(); ++k)
+        {
+            int radius(m_radius_set[k]);
+            std::vector<SumType>& column_sum = column_sum_set[k];
+            double scale(1.0 / double((2 * radius + 1) * (2 * radius + 1)));
+
+            // Initialise the column sums for the first row of the strip
+            if (y == first_row)
+            {
+                for (int dy = -radius; dy <= radius; ++dy)
+                {
+                    const PixelType* p_input = m_src.ptr<PixelType>(mapRow(y + dy));
+                    for (int i = 0; i < width; ++i)
+                    {
+                        column_sum[i] += p_input[i];
+                    }
+                }
+            }
+            // Slide the column sums down by one row
+            else
+            {
+                const PixelType* p_add    = m_src.ptr<PixelType>(mapRow(y + radius));
+                const PixelType* p_remove = m_src.ptr<PixelType>(mapRow(y - radius - 1));
+                for (int i = 0; i < width; ++i)
+                {
+                    column_sum[i] += SumType(p_add[i]) - SumType(p_remove[i]);
+                }
+            }
+
+            // Slide the kernel along the row
+            PixelType* p_output = m_dst[k].ptr<PixelType>(y);
+            for (int channel = 0; channel < channels; ++channel)
+            {
+                SumType sum(0);
+                for (int dx = -radius; dx <= radius; ++dx)
+                {
+                    sum += column_sum[mapColumn(dx) * channels + channel];
+                }
+
+                for (int x = 0; x < m_src.cols; ++x)
+                {
+                    p_output[x * channels + channel] = cv::saturate_cast<PixelType>(sum * scale);
+                    sum += column_sum[mapColumn(x + radius + 1) * channels + channel] -
+                           column_sum[mapColumn(x - radius)     * channels + channel];
+                }
+            }
+        }
+    }
+}
+
+
+#endif // SLIDING_BOX_FILTER_H
@@ -0,0 +1,333 @@
+/**
+********************************************************************************
+*
+*   @file       smallKernels.h
+*
+*   @brief      Mean, Gaussian and Scharr filters specialised at compile time
+*               for radii 1 to 3, 1 or 3 channels, and 8-bit or float pixels.
+*               The radius and the number of channels are template
+*               parameters, so the loops over the taps have a constant trip
+*               count: the compiler unrolls them fully and vectorises the
+*               loops over the pixels of a row. The right specialisation is
+*               selected at runtime; other cases fall back to OpenCV.
+*
+*               The filters are separable. For each output row, a vertical
+*               pass accumulates 2R+1 input rows into a float buffer, the
+*               border columns of the buffer are reflected, then a
+*               horizontal pass produces the output row. The border is
+*               BORDER_REFLECT_101, as in the OpenCV defaults, and no padded
+*               copy of the image is made.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef SMALL_KERNELS_H
+#define SMALL_KERNELS_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <vector>    // Header to store the row buffer
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Separable filter of a strip of rows, specialised by pixel type, number of
+/// channels and radius.
+template<typename PixelType, int CN, int R>
+class SmallSeparableFilterBody : public cv::ParallelLoopBody
+{
+public:
+    SmallSeparableFilterBody(const cv::Mat& src,
+                             cv::Mat& dst,
+                             const float* kernel_x,
+                             const float* kernel_y):
+        m_src(src),
+        m_dst(dst)
+    {
+        for (int k = 0; k < 2 * R + 1; ++k)
+        {
+            m_kernel_x[k] = kernel_x[k];
+            m_kernel_y[k] = kernel_y[k];
+        }
+    }
+
+    virtual void operator()(const cv::Range& range) const;
+
+private:
+    const cv::Mat& m_src;
+    cv::Mat& m_dst;
+    float m_kernel_x[2 * R + 1];
+    float m_kernel_y[2 * R + 1];
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Same as cv::blur with a (2 * radius + 1)^2 kernel.
+inline void smallKernelBlur(const cv::Mat& src, cv::Mat& dst, int radius);
+
+/// Same as cv::GaussianBlur with a (2 * radius + 1)^2 kernel.
+inline void smallKernelGaussianBlur(const cv::Mat& src, cv::Mat& dst, int radius, double sigma);
+
+/// Same as cv::Scharr(src, dst, -1, dx, dy).
+inline void smallKernelScharr(const cv::Mat& src, cv::Mat& dst, int dx, int dy);
+
+/// Run the specialisation of the separable filter that matches the image and
+/// the radius. Return false if there is none.
+inline bool smallSeparableFilter(const cv::Mat& src,
+                                 cv::Mat& dst,
+                                 int radius,
+                                 const float* kernel_x,
+                                 const float* kernel_y);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------------------------------------------------------------------
+template<typename PixelType, int CN, int R>
+void SmallSeparableFilterBody<PixelType, CN, R>::operator()(const cv::Range& range) const
+//-----------------------------------------------------------------------------------------
+{
+    const int K(2 * R + 1);
+    const int width(m_src.cols * CN);
+
+    // Row of vertical sums with R reflected pixels on each side
+    std::vector<float> buffer((m_src.cols + 2 * R) * CN);
+    float* p_buffer = &buffer[R * CN];
+
+    // Columns copied in the border of the buffer
+    int border_column[2 * R];
+    for (int j = 0; j < R; ++j)
+    {
+        border_column[j]     = cv::borderInterpolate(j - R, m_src.cols, cv::BORDER_REFLECT_101);
+        border_column[R + j] = cv::borderInterpolate(m_src.cols + j, m_src.cols, cv::BORDER_REFLECT_101);
+    }
+
+    for (int y = range.start; y < range.end; ++y)
+    {
+        // Vertical pass
+        const PixelType* p_row[K];
+        for (int k = 0; k < K; ++k)
+        {
+            p_row[k] = m_src.ptr<PixelType>(cv::borderInterpolate(y + k - R, m_src.rows, cv::BORDER_REFLECT_101));
+        }
+
+        for (int i = 0; i < width; ++i)
+        {
+            float sum(0.0f);
+            for (int k = 0; k < K; ++k)
+            {
+                sum += m_kernel_y[k] * float(p_row[k][i]);
+            }
+            p_buffer[i] = sum;
+        }
+
+        // Border columns
+        for (int j = 0; j < R; ++j)
+        {
+            for (int c = 0; c < CN; ++c)
+            {
+                p_buffer[(j - R) * CN + c]          = p_buffer[border_column[j] * CN + c];
+                p_buffer[(m_src.cols + j) * CN + c] = p_buffer[border_column[R + j] * CN + c];
+            }
+        }
+
+        // Horizontal pass
+        PixelType* p_output = m_dst.ptr<PixelType>(y);
+        const float* p_first = p_buffer - R * CN;
+        for (int i = 0; i < width; ++i)
+        {
+            float sum(0.0f);
+            for (int k = 0; k < K; ++k)
+            {
+                sum += m_kernel_x[k] * p_first[i + k * CN];
+            }
+            p_output[i] = cv::saturate_cast<PixelType>(sum);
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+template<typename PixelType, int CN, int R>
+void runSmallSeparableFilter(const cv::Mat& src,
+                             cv::Mat& dst,
+                             const float* kernel_x,
+                             const float* kernel_y)
+//------------------------------------------------------------------------------
+{
+    cv::parallel_for_(cv::Range(0, src.rows),
+        SmallSeparableFilterBody<PixelType, CN, R>(src, dst, kernel_x, kernel_y),
+        cv::getNumThreads());
+}
+
+
+//------------------------------------------------------------------------------
+template<typename PixelType, int CN>
+bool dispatchSmallRadius(const cv::Mat& src,
+                         cv::Mat& dst,
+                         int radius,
+                         const float* kernel_x,
+                         const float* kernel_y)
+//------------------------------------------------------------------------------
+{
+    switch (radius)
+    {
+    case 1:
+        runSmallSeparableFilter<PixelType, CN, 1>(src, dst, kernel_x, kernel_y);
+        return true;
+
+    case 2:
+        runSmallSeparableFilter<PixelType, CN, 2>(src, dst, kernel_x, kernel_y);
+        return true;
+
+    case 3:
+        runSmallSeparableFilter<PixelType, CN, 3>(src, dst, kernel_x, kernel_y);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+template<typename PixelType>
+bool dispatchSmallChannels(const cv::Mat& src,
+                           cv::Mat& dst,
+                           int radius,
+                           const float* kernel_x,
+                           const float* kernel_y)
+//------------------------------------------------------------------------------
+{
+    switch (src.channels())
+    {
+    case 1:
+        return dispatchSmallRadius<PixelType, 1>(src, dst, radius, kernel_x, kernel_y);
+
+    case 3:
+        return dispatchSmallRadius<PixelType, 3>(src, dst, radius, kernel_x, kernel_y);
+
+    default:
+        return false;
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline bool smallSeparableFilter(const cv::Mat& src,
+                                 cv::Mat& dst,
+                                 int radius,
+                                 const float* kernel_x,
+                                 const float* kernel_y)
+//------------------------------------------------------------------------------
+{
+    if (radius < 1 || radius > 3 || src.empty() ||
+        (src.channels() != 1 && src.channels() != 3) ||
+        (src.depth() != CV_8U && src.depth() != CV_32F))
+    {
+        return false;
+    }
+
+    // Filtering in place is not possible
+    cv::Mat input = src;
+    if (src.data == dst.data)
+    {
+        input = src.clone();
+    }
+    dst.create(src.size(), src.type());
+
+    if (src.depth() == CV_8U)
+    {
+        return dispatchSmallChannels<unsigned char>(input, dst, radius, kernel_x, kernel_y);
+    }
+    else
+    {
+        return dispatchSmallChannels<float>(input, dst, radius, kernel_x, kernel_y);
+    }
+}
+
+
+//-----------------------------------------------------------------------
+inline void smallKernelBlur(const cv::Mat& src, cv::Mat& dst, int radius)
+//-----------------------------------------------------------------------
+{
+    float kernel[7];
+    for (int k = 0; k < 7; ++k)
+    {
+        kernel[k] = 1.0f / float(2 * radius + 1);
+    }
+
+    if (!smallSeparableFilter(src, dst, radius, kernel, kernel))
+    {
+        cv::blur(src, dst, cv::Size(2 * radius + 1, 2 * radius + 1));
+    }
+}
+
+
+//---------------------------------------------------------------------------------------------
+inline void smallKernelGaussianBlur(const cv::Mat& src, cv::Mat& dst, int radius, double sigma)
+//---------------------------------------------------------------------------------------------
+{
+    if (radius >= 1 && radius <= 3)
+    {
+        cv::Mat kernel_mat = cv::getGaussianKernel(2 * radius + 1, sigma, CV_32F);
+
+        float kernel[7];
+        for (int k = 0; k < 2 * radius + 1; ++k)
+        {
+            kernel[k] = kernel_mat.at<float>(k, 0);
+        }
+
+        if (smallSeparableFilter(src, dst, radius, kernel, kernel))
+        {
+            return;
+        }
+    }
+
+    cv::GaussianBlur(src, dst, cv::Size(2 * radius + 1, 2 * radius + 1), sigma);
+}
+
+
+//-----------------------------------------------------------------------------
+inline void smallKernelScharr(const cv::Mat& src, cv::Mat& dst, int dx, int dy)
+//-----------------------------------------------------------------------------
+{
+    // The Scharr operator is separable: a derivative along one axis and
+    // a smoothing along the other one
+    const float derivative[3] = {-1.0f, 0.0f, 1.0f};
+    const float smoothing[3]  = {3.0f, 10.0f, 3.0f};
+
+    if (src.depth() == CV_32F && ((dx == 1 && dy == 0) || (dx == 0 && dy == 1)))
+    {
+        if (smallSeparableFilter(src, dst, 1,
+            dx ? derivative : smoothing,
+            dx ? smoothing : derivative))
+        {
+            return;
+        }
+    }
+
+    cv::Scharr(src, dst, -1, dx, dy);
+}
+
+
+#endif // SMALL_KERNELS_H
@@ -0,0 +1,178 @@
+/**
+********************************************************************************
+*
+*   @file       spscQueue.h
+*
+*   @brief      Bounded lock-free queue between exactly one producer thread
+*               and one consumer thread, e.g. two stages of a video pipeline.
+*               It is a ring buffer: the producer only writes the tail and
+*               the consumer only writes the head, so no lock is needed, and
+*               the head and the tail are on different cache lines. The
+*               blocking versions of push and pop spin, then yield, then
+*               sleep, until the operation succeeds or a stop flag is raised.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <atomic>  // Header for the head and the tail
+#include <chrono>  // Header for the durations
+#include <cstddef> // Header for size_t
+#include <thread>  // Header to yield and sleep
+#include <vector>  // Header to store the elements
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Bounded single-producer single-consumer queue.
+template<typename T> class SPSCQueue
+{
+public:
+    /// A queue that can hold capacity elements.
+    explicit SPSCQueue(size_t capacity):
+        m_buffer(capacity + 1),
+        m_head(0),
+        m_tail(0)
+    {}
+
+    /// Producer: add an element, return false if the queue is full.
+    bool tryPush(const T& element)
+    {
+        size_t tail(m_tail.load(std::memory_order_relaxed));
+        size_t next(increment(tail));
+
+        if (next == m_head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        m_buffer[tail] = element;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: remove the oldest element, return false if the queue is
+    /// empty.
+    bool tryPop(T& element)
+    {
+        size_t head(m_head.load(std::memory_order_relaxed));
+
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        element = m_buffer[head];
+        m_head.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer: copy the oldest element without removing it, return false
+    /// if the queue is empty.
+    bool tryPeek(T& element) const
+    {
+        size_t head(m_head.load(std::memory_order_relaxed));
+
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        element = m_buffer[head];
+        return true;
+    }
+
+    /// Producer: wait until the element is added. Return false if stop was
+    /// raised first.
+    bool push(const T& element, const std::atomic<bool>& stop)
+    {
+        for (int attempt = 0; !tryPush(element); ++attempt)
+        {
+            if (stop.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+            wait(attempt);
+        }
+        return true;
+    }
+
+    /// Consumer: wait until an element is removed. Return false if stop was
+    /// raised first.
+    bool pop(T& element, const std::atomic<bool>& stop)
+    {
+        for (int attempt = 0; !tryPop(element); ++attempt)
+        {
+            if (stop.load(std::memory_order_relaxed))
+            {
+                return false;
+            }
+            wait(attempt);
+        }
+        return true;
+    }
+
+    /// Number of elements, only exact when both threads are idle.
+    size_t size() const
+    {
+        size_t head(m_head.load(std::memory_order_acquire));
+        size_t tail(m_tail.load(std::memory_order_acquire));
+        return tail >= head ? tail - head : tail + m_buffer.size() - head;
+    }
+
+    size_t capacity() const { return m_buffer.size() - 1; }
+
+    /// Back-off of the blocking operations, after attempt failed attempts.
+    /// Also for a thread that polls several queues.
+    static void wait(int attempt)
+    {
+        if (attempt < 64)
+        {
+            return;
+        }
+        else if (attempt < 128)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+private:
+    size_t increment(size_t index) const
+    {
+        return index + 1 == m_buffer.size() ? 0 : index + 1;
+    }
+
+    /// One more slot than the capacity, to tell a full queue from an empty one
+    std::vector<T> m_buffer;
+
+    std::atomic<size_t> m_head;
+
+    /// Keep the head and the tail on different cache lines. Padding rather
+    /// than alignas, which operator new ignores before C++17.
+    char m_padding[64];
+
+    std::atomic<size_t> m_tail;
+};
+
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,514 @@
+/**
+********************************************************************************
+*
+*   @file       stripImageIO.h
+*
+*   @brief      Sequential reading and writing of 8-bit greyscale or colour
+*               images a few rows at a time, so that images larger than the
+*               memory can be processed. PNM files (binary PGM and PPM) are
+*               always supported, TIFF files (stored in strips, not in
+*               tiles) when the code is compiled with HAVE_LIBTIFF and linked
+*               with libtiff. The rows are exchanged as cv::Mat in the
+*               channel order of cv::imread (BGR).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef STRIP_IMAGE_IO_H
+#define STRIP_IMAGE_IO_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::swap
+#include <cctype>    // Header for isspace and tolower
+#include <fstream>   // Header to read and write PNM files
+#include <memory>    // Header for std::unique_ptr
+#include <sstream>   // Header to write the PNM header
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store a row
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#ifdef HAVE_LIBTIFF
+#include <tiffio.h>  // Header for libtiff
+#endif
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Read the rows of an image from top to bottom.
+class StripReader
+{
+public:
+    virtual ~StripReader() {}
+
+    int getWidth() const  { return m_width; }
+    int getHeight() const { return m_height; }
+    int getType() const   { return m_type; }
+
+    /// Read the next rows.rows rows of the image into rows.
+    virtual void readRows(cv::Mat& rows) = 0;
+
+protected:
+    StripReader(): m_width(0), m_height(0), m_type(CV_8UC1) {}
+
+    int m_width;
+    int m_height;
+    int m_type;
+};
+
+
+/// Write the rows of an image from top to bottom.
+class StripWriter
+{
+public:
+    virtual ~StripWriter() {}
+
+    /// Write the next rows of the image.
+    virtual void writeRows(const cv::Mat& rows) = 0;
+};
+
+
+/// Binary PGM (P5) or PPM (P6) file, with a maximum value of 255.
+class PNMStripReader : public StripReader
+{
+public:
+    explicit PNMStripReader(const std::string& file_name);
+    virtual void readRows(cv::Mat& rows);
+
+private:
+    std::string m_file_name;
+    std::ifstream m_input;
+};
+
+
+class PNMStripWriter : public StripWriter
+{
+public:
+    PNMStripWriter(const std::string& file_name, int width, int height, int type);
+    virtual void writeRows(const cv::Mat& rows);
+
+private:
+    std::string m_file_name;
+    std::ofstream m_output;
+    std::vector<unsigned char> m_row;
+};
+
+
+#ifdef HAVE_LIBTIFF
+/// TIFF file stored in strips, 8 bits per sample, 1 or 3 samples per pixel.
+class TIFFStripReader : public StripReader
+{
+public:
+    explicit TIFFStripReader(const std::string& file_name);
+    virtual ~TIFFStripReader();
+    virtual void readRows(cv::Mat& rows);
+
+private:
+    std::string m_file_name;
+    TIFF* m_p_tiff;
+    int m_next_row;
+};
+
+
+class TIFFStripWriter : public StripWriter
+{
+public:
+    TIFFStripWriter(const std::string& file_name, int width, int height, int type);
+    virtual ~TIFFStripWriter();
+    virtual void writeRows(const cv::Mat& rows);
+
+private:
+    std::string m_file_name;
+    TIFF* m_p_tiff;
+    int m_next_row;
+    std::vector<unsigned char> m_row;
+};
+#endif
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Open a reader depending on the extension of the file.
+inline std::unique_ptr<StripReader> createStripReader(const std::string& file_name);
+
+/// Create a writer depending on the extension of the file.
+inline std::unique_ptr<StripWriter> createStripWriter(const std::string& file_name,
+                                                      int width,
+                                                      int height,
+                                                      int type);
+
+/// Swap the first and third channels of a row of width pixels (RGB <-> BGR).
+inline void swapRedBlue(unsigned char* p_row, int width);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//--------------------------------------------------------------------
+inline std::string getLowerCaseExtension(const std::string& file_name)
+//--------------------------------------------------------------------
+{
+    std::string::size_type extension = file_name.find_last_of('.');
+    if (extension == std::string::npos)
+    {
+        return "";
+    }
+
+    std::string lower_case(file_name.substr(extension + 1));
+    for (std::string::iterator ite = lower_case.begin(); ite != lower_case.end(); ++ite)
+    {
+        *ite = char(std::tolower(*ite));
+    }
+
+    return lower_case;
+}
+
+
+//-------------------------------------------------
+inline bool isPNMFile(const std::string& file_name)
+//-------------------------------------------------
+{
+    std::string extension(getLowerCaseExtension(file_name));
+    return extension == "pnm" || extension == "pgm" || extension == "ppm";
+}
+
+
+//--------------------------------------------------
+inline bool isTIFFFile(const std::string& file_name)
+//--------------------------------------------------
+{
+    std::string extension(getLowerCaseExtension(file_name));
+    return extension == "tif" || extension == "tiff";
+}
+
+
+//---------------------------------------------------------------------------------
+inline std::unique_ptr<StripReader> createStripReader(const std::string& file_name)
+//---------------------------------------------------------------------------------
+{
+    if (isPNMFile(file_name))
+    {
+        return std::unique_ptr<StripReader>(new PNMStripReader(file_name));
+    }
+
+#ifdef HAVE_LIBTIFF
+    if (isTIFFFile(file_name))
+    {
+        return std::unique_ptr<StripReader>(new TIFFStripReader(file_name));
+    }
+#endif
+
+    throw std::string("\"") + file_name + "\" cannot be streamed, use a PNM (.pnm, .pgm, .ppm) or a TIFF (.tif, .tiff) file.";
+}
+
+
+//-----------------------------------------------------------------------------------
+inline std::unique_ptr<StripWriter> createStripWriter(const std::string& file_name,
+                                                      int width,
+                                                      int height,
+                                                      int type)
+//-----------------------------------------------------------------------------------
+{
+    if (isPNMFile(file_name))
+    {
+        return std::unique_ptr<StripWriter>(new PNMStripWriter(file_name, width, height, type));
+    }
+
+#ifdef HAVE_LIBTIFF
+    if (isTIFFFile(file_name))
+    {
+        return std::unique_ptr<StripWriter>(new TIFFStripWriter(file_name, width, height, type));
+    }
+#endif
+
+    throw std::string("\"") + file_name + "\" cannot be streamed, use a PNM (.pnm, .pgm, .ppm) or a TIFF (.tif, .tiff) file.";
+}
+
+
+//------------------------------------------------------
+inline void swapRedBlue(unsigned char* p_row, int width)
+//------------------------------------------------------
+{
+    for (int x = 0; x < width; ++x)
+    {
+        std::swap(p_row[3 * x], p_row[3 * x + 2]);
+    }
+}
+
+
+//------------------------------------------------
+inline int readPNMHeaderValue(std::istream& input)
+//------------------------------------------------
+{
+    // Skip the white spaces and the comments
+    int c(input.peek());
+    while (input && (std::isspace(c) || c == '#'))
+    {
+        if (c == '#')
+        {
+            std::string comment;
+            std::getline(input, comment);
+        }
+        else
+        {
+            input.get();
+        }
+        c = input.peek();
+    }
+
+    int value(-1);
+    input >> value;
+    return value;
+}
+
+
+//------------------------------------------------------------------
+inline PNMStripReader::PNMStripReader(const std::string& file_name):
+//------------------------------------------------------------------
+    m_file_name(file_name),
+    m_input(file_name.c_str(), std::ios::binary)
+{
+    char magic[2] = {0, 0};
+    m_input.read(magic, 2);
+
+    if (!m_input || magic[0] != 'P' || (magic[1] != '5' && magic[1] != '6'))
+    {
+        throw std::string("Could not open the PNM file \"") + m_file_name + "\" (only binary PGM and PPM are supported).";
+    }
+
+    m_width  = readPNMHeaderValue(m_input);
+    m_height = readPNMHeaderValue(m_input);
+    int max_value(readPNMHeaderValue(m_input));
+
+    if (!m_input || m_width <= 0 || m_height <= 0 || max_value <= 0 || max_value > 255)
+    {
+        throw std::string("Invalid or 16-bit PNM header in \"") + m_file_name + "\".";
+    }
+
+    // A single white space separates the header from the pixels
+    m_input.get();
+
+    m_type = magic[1] == '5' ? CV_8UC1 : CV_8UC3;
+}
+
+
+//-------------------------------------------------
+inline void PNMStripReader::readRows(cv::Mat& rows)
+//-------------------------------------------------
+{
+    rows.create(rows.rows, m_width, m_type);
+
+    for (int y = 0; y < rows.rows; ++y)
+    {
+        unsigned char* p_row = rows.ptr<unsigned char>(y);
+        m_input.read(reinterpret_cast<char*>(p_row), m_width * rows.channels());
+
+        if (!m_input)
+        {
+            throw std::string("Unexpected end of the PNM file \"") + m_file_name + "\".";
+        }
+
+        // PPM stores RGB
+        if (m_type == CV_8UC3)
+        {
+            swapRedBlue(p_row, m_width);
+        }
+    }
+}
+
+
+//---------------------------------------------------------------------------------------------------
+inline PNMStripWriter::PNMStripWriter(const std::string& file_name, int width, int height, int type):
+//---------------------------------------------------------------------------------------------------
+    m_file_name(file_name),
+    m_output(file_name.c_str(), std::ios::binary),
+    m_row(width * CV_MAT_CN(type))
+{
+    if (type != CV_8UC1 && type != CV_8UC3)
+    {
+        throw std::string("Only 8-bit greyscale or colour images can be written in \"") + m_file_name + "\".";
+    }
+
+    std::stringstream header;
+    header << (type == CV_8UC1 ? "P5" : "P6") << "\n" << width << " " << height << "\n255\n";
+    m_output << header.str();
+
+    if (!m_output)
+    {
+        throw std::string("Could not write the image \"") + m_file_name + "\".";
+    }
+}
+
+
+//--------------------------------------------------------
+inline void PNMStripWriter::writeRows(const cv::Mat& rows)
+//--------------------------------------------------------
+{
+    for (int y = 0; y < rows.rows; ++y)
+    {
+        const unsigned char* p_row = rows.ptr<unsigned char>(y);
+
+        // PPM stores RGB
+        if (rows.channels() == 3)
+        {
+            std::copy(p_row, p_row + m_row.size(), m_row.begin());
+            swapRedBlue(&m_row[0], rows.cols);
+            p_row = &m_row[0];
+        }
+
+        m_output.write(reinterpret_cast<const char*>(p_row), m_row.size());
+    }
+
+    if (!m_output)
+    {
+        throw std::string("Could not write the image \"") + m_file_name + "\".";
+    }
+}
+
+
+#ifdef HAVE_LIBTIFF
+//--------------------------------------------------------------------
+inline TIFFStripReader::TIFFStripReader(const std::string& file_name):
+//--------------------------------------------------------------------
+    m_file_name(file_name),
+    m_p_tiff(TIFFOpen(file_name.c_str(), "r")),
+    m_next_row(0)
+{
+    if (!m_p_tiff)
+    {
+        throw std::string("Could not open the TIFF file \"") + m_file_name + "\".";
+    }
+
+    uint32_t width(0), height(0);
+    uint16_t samples_per_pixel(1), bits_per_sample(8), planar_config(PLANARCONFIG_CONTIG);
+    TIFFGetField(m_p_tiff, TIFFTAG_IMAGEWIDTH, &width);
+    TIFFGetField(m_p_tiff, TIFFTAG_IMAGELENGTH, &height);
+    TIFFGetFieldDefaulted(m_p_tiff, TIFFTAG_SAMPLESPERPIXEL, &samples_per_pixel);
+    TIFFGetFieldDefaulted(m_p_tiff, TIFFTAG_BITSPERSAMPLE, &bits_per_sample);
+    TIFFGetFieldDefaulted(m_p_tiff, TIFFTAG_PLANARCONFIG, &planar_config);
+
+    if (TIFFIsTiled(m_p_tiff) || bits_per_sample != 8 ||
+        (samples_per_pixel != 1 && samples_per_pixel != 3) ||
+        (samples_per_pixel == 3 && planar_config != PLANARCONFIG_CONTIG))
+    {
+        TIFFClose(m_p_tiff);
+        throw std::string("Only 8-bit greyscale or RGB TIFF files stored in strips can be streamed (\"") + m_file_name + "\").";
+    }
+
+    m_width  = int(width);
+    m_height = int(height);
+    m_type   = samples_per_pixel == 1 ? CV_8UC1 : CV_8UC3;
+}
+
+
+//----------------------------------------
+inline TIFFStripReader::~TIFFStripReader()
+//----------------------------------------
+{
+    TIFFClose(m_p_tiff);
+}
+
+
+//--------------------------------------------------
+inline void TIFFStripReader::readRows(cv::Mat& rows)
+//--------------------------------------------------
+{
+    rows.create(rows.rows, m_width, m_type);
+
+    for (int y = 0; y < rows.rows; ++y, ++m_next_row)
+    {
+        unsigned char* p_row = rows.ptr<unsigned char>(y);
+
+        if (TIFFReadScanline(m_p_tiff, p_row, m_next_row, 0) < 0)
+        {
+            throw std::string("Could not read the TIFF file \"") + m_file_name + "\".";
+        }
+
+        if (m_type == CV_8UC3)
+        {
+            swapRedBlue(p_row, m_width);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------------------------------
+inline TIFFStripWriter::TIFFStripWriter(const std::string& file_name, int width, int height, int type):
+//-----------------------------------------------------------------------------------------------------
+    m_file_name(file_name),
+    m_p_tiff(TIFFOpen(file_name.c_str(), "w")),
+    m_next_row(0),
+    m_row(width * CV_MAT_CN(type))
+{
+    if (!m_p_tiff)
+    {
+        throw std::string("Could not write the image \"") + m_file_name + "\".";
+    }
+
+    if (type != CV_8UC1 && type != CV_8UC3)
+    {
+        TIFFClose(m_p_tiff);
+        throw std::string("Only 8-bit greyscale or colour images can be written in \"") + m_file_name + "\".";
+    }
+
+    int samples_per_pixel(CV_MAT_CN(type));
+    TIFFSetField(m_p_tiff, TIFFTAG_IMAGEWIDTH, uint32_t(width));
+    TIFFSetField(m_p_tiff, TIFFTAG_IMAGELENGTH, uint32_t(height));
+    TIFFSetField(m_p_tiff, TIFFTAG_SAMPLESPERPIXEL, uint16_t(samples_per_pixel));
+    TIFFSetField(m_p_tiff, TIFFTAG_BITSPERSAMPLE, uint16_t(8));
+    TIFFSetField(m_p_tiff, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(m_p_tiff, TIFFTAG_PHOTOMETRIC, samples_per_pixel == 1 ? PHOTOMETRIC_MINISBLACK : PHOTOMETRIC_RGB);
+    TIFFSetField(m_p_tiff, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+    TIFFSetField(m_p_tiff, TIFFTAG_ROWSPERSTRIP, TIFFDefaultStripSize(m_p_tiff, 0));
+}
+
+
+//----------------------------------------
+inline TIFFStripWriter::~TIFFStripWriter()
+//----------------------------------------
+{
+    TIFFClose(m_p_tiff);
+}
+
+
+//---------------------------------------------------------
+inline void TIFFStripWriter::writeRows(const cv::Mat& rows)
+//---------------------------------------------------------
+{
+    for (int y = 0; y < rows.rows; ++y, ++m_next_row)
+    {
+        // libtiff may modify the buffer, and TIFF stores RGB
+        const unsigned char* p_row = rows.ptr<unsigned char>(y);
+        std::copy(p_row, p_row + m_row.size(), m_row.begin());
+
+        if (rows.channels() == 3)
+        {
+            swapRedBlue(&m_row[0], rows.cols);
+        }
+
+        if (TIFFWriteScanline(m_p_tiff, &m_row[0], m_next_row, 0) < 0)
+        {
+            throw std::string("Could not write the image \"") + m_file_name + "\".";
+        }
+    }
+}
+#endif
+
+
+#endif // STRIP_IMAGE_IO_H
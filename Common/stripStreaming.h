@@ -0,0 +1,192 @@
+/**
+********************************************************************************
+*
+*   @file       stripStreaming.h
+*
+*   @brief      Apply a neighbourhood filter to an image that does not fit in
+*               memory. The image is read, filtered and written in horizontal
+*               strips. Each strip is filtered with the halo rows above and
+*               below it, and the rows that are still needed by the next
+*               strip are kept in the buffer instead of being read again.
+*               The peak memory is about (strip_rows + 2 * halo) rows of the
+*               input and of the output.
+*
+*               A filter of radius r only reads the rows up to r pixels away,
+*               so with halo >= r the rows written are identical to the ones
+*               obtained by filtering the whole image: the inner strips never
+*               reach their own border, and the first and last strips start
+*               and end at the border of the image. Each strip is passed to
+*               the filter as a standalone cv::Mat, so that OpenCV does not
+*               read the rows of the buffer beyond it as if they were part of
+*               the image.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef STRIP_STREAMING_H
+#define STRIP_STREAMING_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm>  // Header for std::min and std::max
+#include <cstdlib>    // Header for atoi
+#include <cstring>    // Header for memmove
+#include <functional> // Header for std::function
+#include <memory>     // Header for std::unique_ptr
+#include <string>     // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "stripImageIO.h" // PNM and TIFF strip readers and writers
+
+
+//******************************************************************************
+//    Type declaration
+//******************************************************************************
+
+/// Filter of an image (a strip with its halo rows), e.g. a lambda that calls
+/// the same function as the in-memory path.
+typedef std::function<void(const cv::Mat& src, cv::Mat& dst)> StripFilter;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Read, filter and write the image strip by strip. halo must be at least
+/// the radius of the filter.
+inline void streamFilter(StripReader& reader,
+                         StripWriter& writer,
+                         int halo,
+                         int strip_rows,
+                         const StripFilter& filter);
+
+/// Same as above with the reader and the writer selected by the extensions
+/// of the files. The output has the type of the input.
+inline void streamFilter(const std::string& input_file_name,
+                         const std::string& output_file_name,
+                         int halo,
+                         int strip_rows,
+                         const StripFilter& filter);
+
+/// If the argument is --stream or --stream=N, store the number of rows per
+/// strip (default_rows for --stream) and return true.
+inline bool parseStreamOption(const std::string& argument, int& strip_rows, int default_rows = 256);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//------------------------------------------------------------------------------
+inline void streamFilter(StripReader& reader,
+                         StripWriter& writer,
+                         int halo,
+                         int strip_rows,
+                         const StripFilter& filter)
+//------------------------------------------------------------------------------
+{
+    if (strip_rows < 1 || halo < 0)
+    {
+        throw std::string("Invalid strip size.");
+    }
+
+    const int width(reader.getWidth());
+    const int height(reader.getHeight());
+    const int type(reader.getType());
+
+    // Halo rows above, strip rows, halo rows below
+    cv::Mat buffer(strip_rows + 2 * halo, width, type);
+    cv::Mat output;
+
+    int first_row(0);   // Row of the image in the first row of the buffer
+    int row_count(0);   // Number of rows of the image in the buffer
+    int next_output(0); // Next row of the image to write
+
+    while (next_output < height)
+    {
+        // Read the rows of the strip and its halo below
+        int last_row(std::min(height, next_output + strip_rows + halo));
+        if (last_row - first_row > row_count)
+        {
+            cv::Mat new_rows(last_row - first_row - row_count, width, type,
+                buffer.ptr(row_count), buffer.step);
+            reader.readRows(new_rows);
+            row_count = last_row - first_row;
+        }
+
+        // Standalone header, the filter must not see the rest of the buffer
+        cv::Mat strip(row_count, width, type, buffer.data, buffer.step);
+        filter(strip, output);
+
+        // Write the rows that have all their neighbours in the strip
+        int output_count(std::min(strip_rows, height - next_output));
+        writer.writeRows(output.rowRange(next_output - first_row, next_output - first_row + output_count));
+        next_output += output_count;
+
+        // Keep the halo rows above the next strip
+        int kept_first_row(std::max(first_row, next_output - halo));
+        int shift(kept_first_row - first_row);
+        if (shift > 0)
+        {
+            std::memmove(buffer.ptr(0), buffer.ptr(shift), (row_count - shift) * buffer.step);
+            first_row = kept_first_row;
+            row_count -= shift;
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline void streamFilter(const std::string& input_file_name,
+                         const std::string& output_file_name,
+                         int halo,
+                         int strip_rows,
+                         const StripFilter& filter)
+//------------------------------------------------------------------------------
+{
+    std::unique_ptr<StripReader> p_reader(createStripReader(input_file_name));
+    std::unique_ptr<StripWriter> p_writer(createStripWriter(output_file_name,
+        p_reader->getWidth(), p_reader->getHeight(), p_reader->getType()));
+
+    streamFilter(*p_reader, *p_writer, halo, strip_rows, filter);
+}
+
+
+//-------------------------------------------------------------------------------------------
+inline bool parseStreamOption(const std::string& argument, int& strip_rows, int default_rows)
+//-------------------------------------------------------------------------------------------
+{
+    if (argument == "--stream")
+    {
+        strip_rows = default_rows;
+        return true;
+    }
+
+    if (argument.find("--stream=") != 0)
+    {
+        return false;
+    }
+
+    strip_rows = atoi(argument.substr(std::string("--stream=").size()).c_str());
+
+    if (strip_rows < 1)
+    {
+        throw std::string("The number of rows per strip must be at least 1.");
+    }
+
+    return true;
+}
+
+
+#endif // STRIP_STREAMING_H
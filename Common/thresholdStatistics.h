@@ -0,0 +1,337 @@
+/**
+********************************************************************************
+*
+*   @file       thresholdStatistics.h
+*
+*   @brief      Statistics of an image that is thresholded many times
+*               with thresholds min + (max - min) * p / 256, p in [0, 256],
+*               as with the slider of edgeDetection2. They are computed once:
+*               min, max, a histogram of 257 levels and an 8-bit rank image.
+*               The level of a pixel is the smallest p for which it does not
+*               pass the threshold, so a pixel passes position p if its level
+*               is greater than p. The binary image for a position is then a
+*               single lookup table pass over the rank image, and the number
+*               of pixels that pass is a sum over the histogram.
+*               For a sweep over all the positions, the levels can be
+*               exported as a 16-bit image (the edge map of position p is
+*               level > p) together with the curve of the edge counts.
+*               The image is either a float magnitude or the 16-bit magnitude
+*               of the fixed-point edge pipeline.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef THRESHOLD_STATISTICS_H
+#define THRESHOLD_STATISTICS_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm>  // Header for std::min and std::max
+#include <atomic>     // Header to stop the strips of a cancelled threshold
+#include <cmath>      // Header for ceil
+#include <fstream>    // Header to write the curve of the edge counts
+#include <functional> // Header for the cancellation check
+#include <string>     // Header to manipulate strings
+#include <vector>     // Header to store the histogram
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Cached statistics to threshold an image at any slider position.
+class ThresholdStatistics
+{
+public:
+    /// Number of slider positions minus one: edgeDetection2 sets the
+    /// maximum of its slider to this value.
+    static const int LEVEL_COUNT = 256;
+
+    ThresholdStatistics():
+        m_min(0),
+        m_max(0),
+        m_scale(0),
+        m_histogram(LEVEL_COUNT + 1, 0),
+        m_pass_count(LEVEL_COUNT + 1, 0)
+    {}
+
+    explicit ThresholdStatistics(const cv::Mat& image):
+        m_min(0),
+        m_max(0),
+        m_scale(0),
+        m_histogram(LEVEL_COUNT + 1, 0),
+        m_pass_count(LEVEL_COUNT + 1, 0)
+    {
+        setImage(image);
+    }
+
+    /// Compute the statistics of a CV_32FC1 or CV_16SC1 image. The image is
+    /// kept (not copied) for the positions the rank image cannot represent.
+    void setImage(const cv::Mat& image);
+
+    double getMin() const { return m_min; }
+    double getMax() const { return m_max; }
+
+    /// Threshold of a slider position.
+    double getThreshold(int position) const
+    {
+        return m_min + (m_max - m_min) * (double(position) / double(LEVEL_COUNT));
+    }
+
+    /// Level of a value, in [0, LEVEL_COUNT].
+    int getLevel(float value) const
+    {
+        int level(int(std::ceil((value - m_min) * m_scale)));
+        return std::min(std::max(level, 0), int(LEVEL_COUNT));
+    }
+
+    /// Number of pixels whose level is exactly level.
+    int getHistogram(int level) const { return m_histogram[level]; }
+
+    /// Number of pixels that pass the threshold of a slider position.
+    int getPassCount(int position) const { return m_pass_count[position]; }
+
+    /// The rank image: min(level, 255), CV_8UC1.
+    const cv::Mat& getRankImage() const { return m_rank_image; }
+
+    /// Binary image (CV_8UC1, 0 or 255) of the pixels that pass the
+    /// threshold of a slider position. The strips of rows run in parallel,
+    /// and is_cancelled (if given) is checked before each of them: once it
+    /// returns true, the image is left incomplete and false is returned.
+    bool threshold(int position,
+                   cv::Mat& binary_image,
+                   const std::function<bool()>& is_cancelled = std::function<bool()>()) const;
+
+    /// Same as threshold() with a copy of the rank image, e.g. reduced for a
+    /// preview. Positions 255 and 256 give no pixel.
+    void thresholdRank(int position, const cv::Mat& rank_image, cv::Mat& binary_image) const;
+
+    /// Level of every pixel (CV_16UC1), i.e. the edge maps of all the
+    /// slider positions in a single image.
+    void getLevelImage(cv::Mat& level_image) const;
+
+    /// Write "position,threshold,edge_pixels" for every slider position in
+    /// a CSV file.
+    void writeCurve(const std::string& file_name) const;
+
+private:
+    /// Level of every pixel of row y of the image.
+    void getLevelRow(int y, int* p_level) const;
+
+    template<typename T> void getLevelRow(int y, int* p_level) const
+    {
+        const T* p_input = m_image.ptr<T>(y);
+        for (int x = 0; x < m_image.cols; ++x)
+        {
+            p_level[x] = getLevel(float(p_input[x]));
+        }
+    }
+
+    cv::Mat m_image;
+    cv::Mat m_rank_image;
+    double m_min;
+    double m_max;
+    double m_scale;
+    std::vector<int> m_histogram;
+    std::vector<int> m_pass_count;
+};
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-------------------------------------------------------------
+inline void ThresholdStatistics::setImage(const cv::Mat& image)
+//-------------------------------------------------------------
+{
+    if (image.type() != CV_32FC1 && image.type() != CV_16SC1)
+    {
+        throw std::string("ThresholdStatistics only supports CV_32FC1 and CV_16SC1 images.");
+    }
+
+    m_image = image;
+    cv::minMaxLoc(image, &m_min, &m_max);
+
+    // Constant image: every level is 0 and no pixel ever passes
+    m_scale = m_max > m_min ? LEVEL_COUNT / (m_max - m_min) : 0.0;
+
+    // Levels and histogram
+    std::fill(m_histogram.begin(), m_histogram.end(), 0);
+    m_rank_image.create(image.size(), CV_8UC1);
+    std::vector<int> level_row(image.cols + 1);
+    for (int y = 0; y < image.rows; ++y)
+    {
+        getLevelRow(y, &level_row[0]);
+        unsigned char* p_rank = m_rank_image.ptr<unsigned char>(y);
+
+        for (int x = 0; x < image.cols; ++x)
+        {
+            int level(level_row[x]);
+            ++m_histogram[level];
+            p_rank[x] = (unsigned char)(std::min(level, 255));
+        }
+    }
+
+    // A pixel passes position p if its level is greater than p
+    int count(0);
+    for (int position = LEVEL_COUNT; position >= 0; --position)
+    {
+        m_pass_count[position] = count;
+        count += m_histogram[position];
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline bool ThresholdStatistics::threshold(int position,
+                                           cv::Mat& binary_image,
+                                           const std::function<bool()>& is_cancelled) const
+//------------------------------------------------------------------------------
+{
+    if (m_rank_image.empty())
+    {
+        throw std::string("ThresholdStatistics::threshold called before setImage.");
+    }
+
+    position = std::min(std::max(position, 0), int(LEVEL_COUNT));
+    binary_image.create(m_image.size(), CV_8UC1);
+
+    // Levels 255 and 256 share the same rank, the levels are compared
+    // instead. Below, a lookup table pass over the rank image.
+    cv::Mat lut(1, 256, CV_8UC1);
+    unsigned char* p_lut = lut.ptr<unsigned char>();
+    for (int rank = 0; rank < 256; ++rank)
+    {
+        p_lut[rank] = rank > position ? 255 : 0;
+    }
+
+    // Several strips per thread, so that a cancellation is seen quickly
+    std::atomic<bool> cancelled(false);
+    int strip_count(std::max(1, std::min(4 * cv::getNumThreads(), m_image.rows)));
+    cv::parallel_for_(cv::Range(0, strip_count), [&](const cv::Range& range)
+    {
+        std::vector<int> level_row(position >= 255 ? m_image.cols + 1 : 0);
+
+        for (int strip = range.start; strip < range.end; ++strip)
+        {
+            if (cancelled || (is_cancelled && is_cancelled()))
+            {
+                cancelled = true;
+                return;
+            }
+
+            int first_row(m_image.rows * strip / strip_count);
+            int last_row(m_image.rows * (strip + 1) / strip_count);
+
+            if (position >= 255)
+            {
+                for (int y = first_row; y < last_row; ++y)
+                {
+                    getLevelRow(y, &level_row[0]);
+                    unsigned char* p_binary = binary_image.ptr<unsigned char>(y);
+
+                    for (int x = 0; x < m_image.cols; ++x)
+                    {
+                        p_binary[x] = level_row[x] > position ? 255 : 0;
+                    }
+                }
+            }
+            else
+            {
+                cv::Mat binary_strip(binary_image.rowRange(first_row, last_row));
+                cv::LUT(m_rank_image.rowRange(first_row, last_row), lut, binary_strip);
+            }
+        }
+    });
+
+    return !cancelled;
+}
+
+
+//------------------------------------------------------------------------------
+inline void ThresholdStatistics::thresholdRank(int position,
+                                               const cv::Mat& rank_image,
+                                               cv::Mat& binary_image) const
+//------------------------------------------------------------------------------
+{
+    cv::Mat lut(1, 256, CV_8UC1);
+    unsigned char* p_lut = lut.ptr<unsigned char>();
+    for (int rank = 0; rank < 256; ++rank)
+    {
+        p_lut[rank] = rank > position ? 255 : 0;
+    }
+
+    cv::LUT(rank_image, lut, binary_image);
+}
+
+
+//------------------------------------------------------------------------
+inline void ThresholdStatistics::getLevelImage(cv::Mat& level_image) const
+//------------------------------------------------------------------------
+{
+    level_image.create(m_image.size(), CV_16UC1);
+    std::vector<int> level_row(m_image.cols + 1);
+    for (int y = 0; y < m_image.rows; ++y)
+    {
+        getLevelRow(y, &level_row[0]);
+        unsigned short* p_level = level_image.ptr<unsigned short>(y);
+
+        for (int x = 0; x < m_image.cols; ++x)
+        {
+            p_level[x] = (unsigned short)(level_row[x]);
+        }
+    }
+}
+
+
+//---------------------------------------------------------------------
+inline void ThresholdStatistics::getLevelRow(int y, int* p_level) const
+//---------------------------------------------------------------------
+{
+    if (m_image.depth() == CV_16S)
+    {
+        getLevelRow<short>(y, p_level);
+    }
+    else
+    {
+        getLevelRow<float>(y, p_level);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+inline void ThresholdStatistics::writeCurve(const std::string& file_name) const
+//-----------------------------------------------------------------------------
+{
+    std::ofstream output_file(file_name.c_str());
+
+    if (!output_file.is_open())
+    {
+        throw std::string("Could not write the file \"") + file_name + "\".";
+    }
+
+    output_file << "position,threshold,edge_pixels" << std::endl;
+    output_file.precision(9);
+    for (int position = 0; position <= LEVEL_COUNT; ++position)
+    {
+        output_file << position << ","
+                    << getThreshold(position) << ","
+                    << getPassCount(position) << std::endl;
+    }
+}
+
+
+#endif // THRESHOLD_STATISTICS_H
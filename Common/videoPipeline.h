@@ -0,0 +1,365 @@
+/**
+********************************************************************************
+*
+*   @file       videoPipeline.h
+*
+*   @brief      Building blocks of the pipelined video programs of Lab-09,
+*               where decoding, processing and encoding run in their own
+*               threads, connected by bounded SPSC queues (spscQueue.h).
+*               The frames are allocated once, in a pool, and go round the
+*               pipeline: the buffers are reused by the next frame instead of
+*               being allocated for every frame. Each stage measures how long
+*               it works, how long it waits for a frame from the previous
+*               stage (starved), and how long it waits for room in the queue
+*               of the next stage (blocked). The stage that is busy most of
+*               the time is the bottleneck.
+*               A stage can also be run by several workers, each with its own
+*               queues: the frames are handed to any worker with room, and
+*               the reorder buffer puts them back in sequence.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef VIDEO_PIPELINE_H
+#define VIDEO_PIPELINE_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::max
+#include <atomic>    // Header for the stop flag
+#include <cstddef>   // Header for size_t
+#include <cstdlib>   // Header for atoi
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <memory>    // Header for std::unique_ptr
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the frames and the stages
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "spscQueue.h" // Lock-free queue between two threads
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Buffers of a frame, kept from one frame to the next.
+struct VideoFrame
+{
+    VideoFrame():
+        index(-1)
+    {}
+
+    /// Position in the video, to check the order of the frames
+    long index;
+
+    /// Frame as decoded
+    cv::Mat captured_image;
+
+    /// Frame after the scaling factor
+    cv::Mat image;
+
+    /// Result of the processing
+    cv::Mat processed_image;
+
+    /// Image displayed and encoded
+    cv::Mat displayed_image;
+};
+
+
+/// Queue of frames between two stages, 0 marks the end of the video.
+typedef SPSCQueue<VideoFrame*> VideoFrameQueue;
+
+/// One queue per worker of a stage (the queues cannot be copied).
+typedef std::vector<std::unique_ptr<VideoFrameQueue> > VideoFrameQueueSet;
+
+
+/// Fixed set of frames. The frames are acquired by the first stage and
+/// released by the last stage, and the free frames are in an SPSC queue, so
+/// acquire() and release() must each be called from a single thread.
+class FramePool
+{
+public:
+    explicit FramePool(size_t frame_count):
+        m_frames(frame_count),
+        m_free_frames(frame_count)
+    {
+        for (size_t i = 0; i < frame_count; ++i)
+        {
+            m_free_frames.tryPush(&m_frames[i]);
+        }
+    }
+
+    /// Wait for a free frame. Return false if stop was raised first.
+    bool acquire(VideoFrame*& p_frame, const std::atomic<bool>& stop)
+    {
+        return m_free_frames.pop(p_frame, stop);
+    }
+
+    /// Give back a frame of the pool.
+    void release(VideoFrame* p_frame)
+    {
+        // There is always room for all the frames
+        m_free_frames.tryPush(p_frame);
+    }
+
+    size_t size() const { return m_frames.size(); }
+
+private:
+    std::vector<VideoFrame> m_frames;
+    VideoFrameQueue m_free_frames;
+};
+
+
+/// Frames processed out of order, given back in sequence. At most capacity
+/// frames can be in flight, e.g. the size of the frame pool, so that the
+/// frame of each index has its own slot (index % capacity). Only used by the
+/// thread that collects the frames.
+class ReorderBuffer
+{
+public:
+    explicit ReorderBuffer(size_t capacity):
+        m_frames(capacity, 0),
+        m_next_index(0),
+        m_size(0),
+        m_peak_size(0)
+    {}
+
+    /// Add a frame, in any order.
+    void insert(VideoFrame* p_frame)
+    {
+        VideoFrame*& p_slot(m_frames[p_frame->index % m_frames.size()]);
+
+        if (p_slot || p_frame->index < m_next_index)
+        {
+            throw std::string("ReorderBuffer: too many frames in flight.");
+        }
+
+        p_slot = p_frame;
+        m_peak_size = std::max(m_peak_size, ++m_size);
+    }
+
+    /// Remove the next frame in sequence, or return 0 if it is not there yet.
+    VideoFrame* takeNext()
+    {
+        VideoFrame*& p_slot(m_frames[m_next_index % m_frames.size()]);
+        VideoFrame* p_frame(p_slot);
+
+        if (p_frame)
+        {
+            p_slot = 0;
+            ++m_next_index;
+            --m_size;
+        }
+
+        return p_frame;
+    }
+
+    size_t size() const { return m_size; }
+
+    /// Largest number of frames that waited for an earlier frame.
+    size_t getPeakSize() const { return m_peak_size; }
+
+private:
+    std::vector<VideoFrame*> m_frames;
+    long m_next_index;
+    size_t m_size;
+    size_t m_peak_size;
+};
+
+
+/// Time spent by a pipeline stage, only updated by the thread of the stage.
+class StageStatistics
+{
+public:
+    explicit StageStatistics(const std::string& name = std::string()):
+        m_name(name),
+        m_frame_count(0),
+        m_starved_ticks(0),
+        m_busy_ticks(0),
+        m_blocked_ticks(0)
+    {}
+
+    /// Add a frame, from the tick counts (cv::getTickCount()) when the stage
+    /// started to wait for it, when it got it, when it was processed and
+    /// when the next stage accepted it.
+    void addFrame(int64 wait_start, int64 work_start, int64 work_end, int64 push_end)
+    {
+        addTimes(work_start - wait_start, work_end - work_start, push_end - work_end);
+    }
+
+    /// Add a frame, from the durations in ticks.
+    void addTimes(int64 starved_ticks, int64 busy_ticks, int64 blocked_ticks)
+    {
+        ++m_frame_count;
+        m_starved_ticks += starved_ticks;
+        m_busy_ticks += busy_ticks;
+        m_blocked_ticks += blocked_ticks;
+    }
+
+    const std::string& getName() const { return m_name; }
+    long getFrameCount() const { return m_frame_count; }
+    int64 getStarvedTicks() const { return m_starved_ticks; }
+    int64 getBusyTicks() const { return m_busy_ticks; }
+    int64 getBlockedTicks() const { return m_blocked_ticks; }
+
+private:
+    std::string m_name;
+    long m_frame_count;
+    int64 m_starved_ticks;
+    int64 m_busy_ticks;
+    int64 m_blocked_ticks;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Create worker_count queues of the given capacity.
+inline void createQueueSet(VideoFrameQueueSet& queue_set, int worker_count, size_t capacity);
+
+/// Push a frame in the first queue of queue_set with room, starting after
+/// the queue used last time (next_queue is updated), so the workers that are
+/// ahead get more frames. Wait if all the queues are full. Return false if
+/// stop was raised first.
+inline bool pushToAnyQueue(VideoFrameQueueSet& queue_set,
+                           VideoFrame* p_frame,
+                           size_t& next_queue,
+                           const std::atomic<bool>& stop);
+
+/// Parse "--workers=N", the number of threads of the processing stage.
+/// Return false if the argument is not this option.
+inline bool parseWorkerOption(const std::string& argument, int& worker_count);
+
+/// Print the frame count, the time per frame and the fractions of
+/// elapsed_ticks during which each stage was busy, starved and blocked. The
+/// stage with the highest occupancy (busy fraction) is the bottleneck.
+inline void printStageStatistics(std::ostream& output,
+                                 const std::vector<StageStatistics>& stage_set,
+                                 int64 elapsed_ticks);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//------------------------------------------------------------------------------------------
+inline void createQueueSet(VideoFrameQueueSet& queue_set, int worker_count, size_t capacity)
+//------------------------------------------------------------------------------------------
+{
+    queue_set.clear();
+    for (int i = 0; i < worker_count; ++i)
+    {
+        queue_set.push_back(std::unique_ptr<VideoFrameQueue>(new VideoFrameQueue(capacity)));
+    }
+}
+
+
+//------------------------------------------------------------------------------
+inline bool pushToAnyQueue(VideoFrameQueueSet& queue_set,
+                           VideoFrame* p_frame,
+                           size_t& next_queue,
+                           const std::atomic<bool>& stop)
+//------------------------------------------------------------------------------
+{
+    for (int attempt = 0; ; ++attempt)
+    {
+        for (size_t i = 0; i < queue_set.size(); ++i)
+        {
+            size_t queue((next_queue + i) % queue_set.size());
+
+            if (queue_set[queue]->tryPush(p_frame))
+            {
+                next_queue = (queue + 1) % queue_set.size();
+                return true;
+            }
+        }
+
+        if (stop.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        VideoFrameQueue::wait(attempt);
+    }
+}
+
+
+//---------------------------------------------------------------------------
+inline bool parseWorkerOption(const std::string& argument, int& worker_count)
+//---------------------------------------------------------------------------
+{
+    if (argument.find("--workers=") != 0)
+    {
+        return false;
+    }
+
+    worker_count = atoi(argument.substr(std::string("--workers=").size()).c_str());
+
+    if (worker_count < 1)
+    {
+        throw std::string("The number of workers must be at least 1.");
+    }
+
+    return true;
+}
+
+
+//------------------------------------------------------------------------------
+inline void printStageStatistics(std::ostream& output,
+                                 const std::vector<StageStatistics>& stage_set,
+                                 int64 elapsed_ticks)
+//------------------------------------------------------------------------------
+{
+    double tick_frequency(cv::getTickFrequency());
+    double elapsed(std::max(int64(1), elapsed_ticks));
+
+    output << "Elapsed time: " << std::fixed << std::setprecision(3)
+           << elapsed_ticks / tick_frequency << " s" << std::endl;
+
+    output << std::setw(10) << "stage"
+           << std::setw(9) << "frames"
+           << std::setw(11) << "ms/frame"
+           << std::setw(11) << "occupancy"
+           << std::setw(10) << "starved"
+           << std::setw(10) << "blocked" << std::endl;
+
+    size_t bottleneck(0);
+    for (size_t i = 0; i < stage_set.size(); ++i)
+    {
+        const StageStatistics& stage(stage_set[i]);
+        long frame_count(std::max(1L, stage.getFrameCount()));
+
+        output << std::setw(10) << stage.getName()
+               << std::setw(9) << stage.getFrameCount()
+               << std::setw(11) << std::setprecision(2) << 1000.0 * stage.getBusyTicks() / tick_frequency / frame_count
+               << std::setw(10) << std::setprecision(1) << 100.0 * stage.getBusyTicks() / elapsed << "%"
+               << std::setw(9) << 100.0 * stage.getStarvedTicks() / elapsed << "%"
+               << std::setw(9) << 100.0 * stage.getBlockedTicks() / elapsed << "%" << std::endl;
+
+        if (stage.getBusyTicks() > stage_set[bottleneck].getBusyTicks())
+        {
+            bottleneck = i;
+        }
+    }
+
+    if (!stage_set.empty())
+    {
+        output << "Bottleneck: " << stage_set[bottleneck].getName() << std::endl;
+    }
+}
+
+
+#endif // VIDEO_PIPELINE_H
@@ -22,8 +22,12 @@
 //******************************************************************************
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/imageLoader.h" // Decode-time reduction of the image
+
 
 //******************************************************************************
 //	Namespaces
@@ -52,14 +56,27 @@ int main(int argc, char** argv)
 {
     try
     {
+        // Separate the options from the file names
+        int scale_denominator(1);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (!parseScaleOption(argument, scale_denominator))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
-        if (argc != 2)
+        if (arguments.size() != 1)
         {
             // Create an error message
             std::string error_message;
             error_message  = "usage: ";
             error_message += argv[0];
-            error_message += " <input_image>";
+            error_message += " <input_image> [--scale=1|2|4|8]";
 
             // Throw an error
             throw error_message;
@@ -69,11 +86,11 @@ int main(int argc, char** argv)
         //....
         //....
         //....
-		string input_filename(argv[1]);
+		string input_filename(arguments[0]);
 		// Create an image instance
 		
 
-		cv::Mat image = cv::imread(input_filename, CV_LOAD_IMAGE_COLOR);
+		cv::Mat image = loadImage(input_filename, BGR_CHANNELS, scale_denominator);
 		// The image has not been loaded
 		if (!image.data) // Some people use if (image.empty())
 		{
@@ -22,8 +22,15 @@
 #include <cstdlib>   // Header for atoi and atof
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/imageLoader.h"       // Decode-time reduction of the image
+#include "../Common/recursiveGaussian.h" // Sigma-independent Gaussian filter
+#include "../Common/smallKernels.h"      // Specialised kernels for radii 1 to 3
+#include "../Common/stripStreaming.h"    // Strip-by-strip filtering of large images
+
 
 //******************************************************************************
 //	Namespaces
@@ -37,15 +44,41 @@ int main(int argc, char** argv)
 {
     try
     {
+        // Separate the options from the file names
+        std::string engine("fir");
+        int scale_denominator(1);
+        int strip_rows(0);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (argument.find("--engine=") == 0)
+            {
+                engine = argument.substr(std::string("--engine=").size());
+            }
+            else if (!parseScaleOption(argument, scale_denominator) &&
+                !parseStreamOption(argument, strip_rows))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
         // No file to save
-        if (argc != 5)
+        // The support of the recursive filter is infinite, it cannot be
+        // computed exactly from a finite number of halo rows
+        if (arguments.size() != 4 || (engine != "fir" && engine != "iir") ||
+            (strip_rows && (engine == "iir" || scale_denominator != 1)))
         {
             // Create an error message
             std::string error_message;
             error_message  = "usage: ";
             error_message += argv[0];
-            error_message += " <input_image>  <output_image>  <radius>  <sigma>";
+            error_message += " <input_image>  <output_image>  <radius>  <sigma>  [--engine=fir|iir] [--scale=1|2|4|8]";
+            error_message += "\n       ";
+            error_message += argv[0];
+            error_message += " <input.pnm|tif>  <output.pnm|tif>  <radius>  <sigma>  --stream[=rows]";
 
             // Throw an error
             throw error_message;
@@ -56,26 +89,47 @@ int main(int argc, char** argv)
 		unsigned int radius(1);
 		double sigma(1);
 
-		if (argc == 4)
-		{
-			radius = atoi(argv[3]);
-		}
-		if (argc == 5)
-		{
-			sigma = stod(argv[4]);
-		}
+		radius = atoi(arguments[2].c_str());
+		sigma = stod(arguments[3]);
 		unsigned int kernel_dim = (radius * 2) + 1; //calculate kernel dimensions 
 		//Filter Size
 		cv::Size filter_size(kernel_dim, kernel_dim);
 
-		string input_filename(argv[1]);
-		string output_filename(argv[2]);
-		
+		string input_filename(arguments[0]);
+		string output_filename(arguments[1]);
+
+		// The same filter is used in memory and in streaming mode
+		StripFilter filter = [&](const cv::Mat& src, cv::Mat& dst)
+		{
+			// The recursive filter ignores the radius, its support is infinite
+			// and its cost does not grow with sigma
+			if (engine == "iir")
+			{
+				recursiveGaussianBlur(src, dst, sigma);
+			}
+			// Specialised kernels for radii 1 to 3, cv::GaussianBlur otherwise
+			else
+			{
+				smallKernelGaussianBlur(src, dst, radius, sigma);
+			}
+		};
+
+		// Streaming: the image is read, filtered and written in strips of
+		// rows and is never held in memory as a whole. The output is the same
+		// as in memory, but the image is not displayed
+		if (strip_rows)
+		{
+			streamFilter(input_filename, output_filename, radius, strip_rows, filter);
+			return 0;
+		}
+
 
 		// Create an image instance
 
 
-		cv::Mat image = cv::imread(input_filename, CV_LOAD_IMAGE_COLOR);
+		// The image is decoded at 1/scale of its size, the radius is in
+		// pixels of the decoded image
+		cv::Mat image = loadImage(input_filename, BGR_CHANNELS, scale_denominator);
 
 		// The image has not been loaded
 		if (!image.data)
@@ -90,7 +144,7 @@ int main(int argc, char** argv)
 		}
 
 		cv::Mat filterImage;
-		cv::GaussianBlur(image, filterImage, filter_size, sigma);
+		filter(image, filterImage);
 
 		string window_title;
 		window_title = "Display_\"";
@@ -107,7 +161,7 @@ int main(int argc, char** argv)
 			//image has not been writen
 			string error_message;
 			error_message = "Could not write the image \"";
-			error_message += argv[2];
+			error_message += output_filename;
 			error_message += "\".";
 
 			throw error_message;
@@ -0,0 +1,208 @@
+/**
+********************************************************************************
+*
+*   @file       gaussianFilterBenchmark.cxx
+*
+*   @brief      A program to compare the accuracy and the runtime of the
+*               recursive (IIR) Gaussian filter with cv::GaussianBlur (FIR)
+*               for increasing values of sigma. The FIR kernel is truncated
+*               at 4 sigma and is used as the reference.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <cmath>     // Header for log10 and ceil
+#include <cstdlib>   // Header for atof
+#include <exception> // Header for catching exceptions
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the values of sigma
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/recursiveGaussian.h" // Sigma-independent Gaussian filter
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Global variables
+//******************************************************************************
+const double g_default_sigma_set[] = {1.0, 2.0, 5.0, 10.0, 20.0, 40.0};
+const int g_repetitions = 3;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+double timeFIR(const cv::Mat& image, cv::Mat& output, double sigma);
+double timeIIR(const cv::Mat& image, cv::Mat& output, double sigma);
+double computePSNR(const cv::Mat& reference, const cv::Mat& test);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    try
+    {
+        // No file to process
+        if (argc < 2)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "usage: ";
+            error_message += argv[0];
+            error_message += " <input_image> [sigma_1 sigma_2 ...]";
+
+            // Throw an error
+            throw error_message;
+        }
+
+        // Values of sigma to test
+        std::vector<double> sigma_set;
+        for (int i = 2; i < argc; ++i)
+        {
+            sigma_set.push_back(atof(argv[i]));
+        }
+
+        if (sigma_set.empty())
+        {
+            sigma_set.assign(g_default_sigma_set,
+                g_default_sigma_set + sizeof(g_default_sigma_set) / sizeof(g_default_sigma_set[0]));
+        }
+
+        // Open and read the image
+        cv::Mat image = cv::imread(argv[1], CV_LOAD_IMAGE_COLOR);
+
+        // The image has not been loaded
+        if (!image.data)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "Could not open or find the image \"";
+            error_message += argv[1];
+            error_message += "\".";
+
+            // Throw an error
+            throw error_message;
+        }
+
+        cout << "Image: " << image.cols << "x" << image.rows << "x" << image.channels()
+             << ", threads: " << cv::getNumThreads() << endl;
+        cout << setw(8) << "sigma"
+             << setw(8) << "radius"
+             << setw(12) << "FIR (ms)"
+             << setw(12) << "IIR (ms)"
+             << setw(10) << "speedup"
+             << setw(12) << "PSNR (dB)"
+             << setw(10) << "max diff" << endl;
+
+        for (std::vector<double>::const_iterator ite = sigma_set.begin(); ite != sigma_set.end(); ++ite)
+        {
+            double sigma(*ite);
+            int radius(int(std::ceil(4.0 * sigma)));
+
+            cv::Mat reference, output;
+            double fir_time(timeFIR(image, reference, sigma));
+            double iir_time(timeIIR(image, output, sigma));
+
+            cout << setw(8) << fixed << setprecision(1) << sigma
+                 << setw(8) << radius
+                 << setw(12) << setprecision(2) << fir_time
+                 << setw(12) << iir_time
+                 << setw(10) << fir_time / iir_time
+                 << setw(12) << computePSNR(reference, output)
+                 << setw(10) << setprecision(0) << cv::norm(reference, output, cv::NORM_INF) << endl;
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+
+    // Exit the program
+    return 0;
+}
+
+
+//-----------------------------------------------------------------
+double timeFIR(const cv::Mat& image, cv::Mat& output, double sigma)
+//-----------------------------------------------------------------
+{
+    int kernel_dim(2 * int(std::ceil(4.0 * sigma)) + 1);
+
+    double best_time(1.0e30);
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        cv::GaussianBlur(image, output, cv::Size(kernel_dim, kernel_dim), sigma, sigma, cv::BORDER_REPLICATE);
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+    return best_time;
+}
+
+
+//-----------------------------------------------------------------
+double timeIIR(const cv::Mat& image, cv::Mat& output, double sigma)
+//-----------------------------------------------------------------
+{
+    double best_time(1.0e30);
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        recursiveGaussianBlur(image, output, sigma);
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+    return best_time;
+}
+
+
+//---------------------------------------------------------------
+double computePSNR(const cv::Mat& reference, const cv::Mat& test)
+//---------------------------------------------------------------
+{
+    double error(cv::norm(reference, test, cv::NORM_L2));
+    double mse(error * error / double(reference.total() * reference.channels()));
+
+    // Identical images
+    if (mse <= 0.0)
+    {
+        return 99.99;
+    }
+
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
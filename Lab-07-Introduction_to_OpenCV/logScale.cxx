@@ -23,8 +23,13 @@
 //******************************************************************************
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/imageLoader.h"    // Decode-time greyscale and reduction
+#include "../Common/pointOperation.h" // Lookup-table point operations
+
 
 //******************************************************************************
 //	Namespaces
@@ -38,28 +43,42 @@ int main(int argc, char** argv)
 {
     try
     {
+        // Separate the options from the file names
+        int scale_denominator(1);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (!parseScaleOption(argument, scale_denominator))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
         // No file to save
-        if (argc != 3)
+        if (arguments.size() != 2)
         {
             // Create an error message
             std::string error_message;
             error_message  = "usage: ";
             error_message += argv[0];
-            error_message += " <input_image>  <output_image>";
+            error_message += " <input_image>  <output_image> [--scale=1|2|4|8]";
 
             // Throw an error
             throw error_message;
         }
 
         // Write your own code here
-		string input_filename(argv[1]);
-		string output_filename(argv[2]);
+		string input_filename(arguments[0]);
+		string output_filename(arguments[1]);
 
 		// Create an image instance
 
 
-		cv::Mat image = cv::imread(input_filename, CV_LOAD_IMAGE_COLOR);
+		// Only the greyscale image is used, let the decoder produce it
+		cv::Mat image = loadImage(input_filename, GREY_CHANNEL, scale_denominator);
 
 		// The image has not been loaded
 		if (!image.data)
@@ -73,23 +92,14 @@ int main(int argc, char** argv)
 			throw error_message;
 		}
 
-		//convert rgb image to grayscale
+		// Log transformation, normalised between the min and max intensities.
+		// The greyscale conversion, the log and the normalisation are folded
+		// into a 256-entry lookup table: one pass to find the range from the
+		// histogram, one pass to map the pixels (and keep the greyscale image
+		// for display).
 		cv::Mat grey_image;
-		cv::cvtColor(image, grey_image, CV_RGB2GRAY);
-
-		//Convert to float
-		cv::Mat float_image;
-		grey_image.convertTo(float_image, CV_32FC1);
-
-		//Log transformation
-		cv::Mat log_image;
-		cv::log(float_image + 1.0, log_image);
-
-		//normalise image
-		double min, max;
-		cv::minMaxLoc(log_image, &min, &max);
-		cv::Mat normalised_image = 255.0 * (log_image - min) / (max - min);
-		normalised_image.convertTo(normalised_image, CV_8UC1);
+		cv::Mat normalised_image;
+		applyPointOperation(image, PointOperation::logScale(), normalised_image, &grey_image);
 
 
 
@@ -122,7 +132,7 @@ int main(int argc, char** argv)
 			//image has not been writen
 			string error_message;
 			error_message = "Could not write the image \"";
-			error_message += argv[2];
+			error_message += output_filename;
 			error_message += "\".";
 
 			throw error_message;
@@ -22,8 +22,16 @@
 #include <cstdlib>   // Header for atoi and atof
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
+#include <sstream>   // Header to parse the list of radii
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/imageLoader.h"      // Decode-time reduction of the image
+#include "../Common/slidingBoxFilter.h" // Radius-independent mean filter
+#include "../Common/smallKernels.h"     // Specialised kernels for radii 1 to 3
+#include "../Common/stripStreaming.h"   // Strip-by-strip filtering of large images
+
 
 //******************************************************************************
 //	Namespaces
@@ -39,6 +47,8 @@ using namespace std;
 //******************************************************************************
 //	Function declaration
 //******************************************************************************
+std::vector<int> parseRadii(const std::string& radius_list);
+std::string radiusFileName(const std::string& file_name, int radius);
 
 
 //******************************************************************************
@@ -52,15 +62,49 @@ int main(int argc, char** argv)
 {
     try
     {
+        // Separate the options from the file names
+        std::string engine("opencv");
+        std::vector<int> radius_set;
+        int scale_denominator(1);
+        int strip_rows(0);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (argument.find("--engine=") == 0)
+            {
+                engine = argument.substr(std::string("--engine=").size());
+            }
+            else if (argument.find("--radii=") == 0)
+            {
+                radius_set = parseRadii(argument.substr(std::string("--radii=").size()));
+            }
+            else if (!parseScaleOption(argument, scale_denominator) &&
+                !parseStreamOption(argument, strip_rows))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
         // No file to save
-        if (argc != 3 && argc != 4)
+        if ((arguments.size() != 2 && arguments.size() != 3) ||
+            (engine != "opencv" && engine != "sliding") ||
+            (radius_set.size() && arguments.size() == 3) ||
+            (strip_rows && (radius_set.size() || scale_denominator != 1)))
         {
             // Create an error message
             std::string error_message;
             error_message  = "usage: ";
             error_message += argv[0];
-            error_message += " <input_image>  <output_image> <kernel_radius>";
+            error_message += " <input_image>  <output_image> <kernel_radius> [--engine=opencv|sliding] [--scale=1|2|4|8]";
+            error_message += "\n       ";
+            error_message += argv[0];
+            error_message += " <input.pnm|tif>  <output.pnm|tif> <kernel_radius> [--engine=opencv|sliding] --stream[=rows]";
+            error_message += "\n       ";
+            error_message += argv[0];
+            error_message += " <input_image>  <output_image> --radii=1,3,7,15 [--scale=1|2|4|8]";
 
             // Throw an error
             throw error_message;
@@ -69,9 +113,9 @@ int main(int argc, char** argv)
         // Filter radius
         unsigned int radius(1);
 
-        if (argc == 4)
+        if (arguments.size() == 3)
         {
-            radius = atoi(argv[3]);
+            radius = atoi(arguments[2].c_str());
         }
     
         // Write your own code here
@@ -79,13 +123,39 @@ int main(int argc, char** argv)
 		//Filter Size
 		cv::Size filter_size(kernel_dim, kernel_dim);
 
-		string input_filename(argv[1]);
-		string output_filename(argv[2]);
+		string input_filename(arguments[0]);
+		string output_filename(arguments[1]);
+
+		// The same filter is used in memory and in streaming mode
+		StripFilter filter = [&](const cv::Mat& src, cv::Mat& dst)
+		{
+			// The cost of the sliding sums does not grow with the radius
+			if (engine == "sliding")
+			{
+				slidingBoxFilter(src, dst, radius);
+			}
+			// Specialised kernels for radii 1 to 3, cv::blur otherwise
+			else
+			{
+				smallKernelBlur(src, dst, radius);
+			}
+		};
+
+		// Streaming: the image is read, filtered and written in strips of
+		// rows and is never held in memory as a whole. The output is the same
+		// as in memory, but the image is not displayed
+		if (strip_rows)
+		{
+			streamFilter(input_filename, output_filename, radius, strip_rows, filter);
+			return 0;
+		}
 
 		// Create an image instance
 
 
-		cv::Mat image = cv::imread(input_filename, CV_LOAD_IMAGE_COLOR);
+		// The image is decoded at 1/scale of its size, the radius is in
+		// pixels of the decoded image
+		cv::Mat image = loadImage(input_filename, BGR_CHANNELS, scale_denominator);
 		
 		// The image has not been loaded
 		if (!image.data)
@@ -99,8 +169,46 @@ int main(int argc, char** argv)
 			throw error_message;
 		}
 
+		// Several radii: all the outputs are computed in a single pass
+		// and saved as <output_image>_r<radius>.<extension>
+		if (radius_set.size())
+		{
+			std::vector<cv::Mat> filter_image_set;
+			slidingBoxFilter(image, filter_image_set, radius_set);
+
+			for (unsigned int i = 0; i < radius_set.size(); ++i)
+			{
+				string file_name(radiusFileName(output_filename, radius_set[i]));
+
+				//create window
+				string window_title;
+				window_title = "Display_\"";
+				window_title += file_name;
+				window_title += "\"";
+				cv::namedWindow(window_title, cv::WINDOW_AUTOSIZE);
+
+				//Show image in window
+				cv::imshow(window_title, filter_image_set[i]);
+
+				//Save  image
+				if (!cv::imwrite(file_name, filter_image_set[i])) {
+					//image has not been writen
+					string error_message;
+					error_message = "Could not write the image \"";
+					error_message += file_name;
+					error_message += "\".";
+
+					throw error_message;
+				}
+			}
+
+			cv::waitKey(0);
+			return 0;
+		}
+
 		cv::Mat filterImage;
-		cv::blur(image, filterImage, filter_size);
+		filter(image, filterImage);
+
 
 		string window_title;
 		window_title = "Display_\"";
@@ -117,7 +225,7 @@ int main(int argc, char** argv)
 			//image has not been writen
 			string error_message; 
 			error_message = "Could not write the image \"";
-			error_message += argv[2];
+			error_message += output_filename;
 			error_message += "\".";
 
 			throw error_message;
@@ -157,3 +265,49 @@ int main(int argc, char** argv)
     return 0;
 }
 
+
+//---------------------------------------------------------
+std::vector<int> parseRadii(const std::string& radius_list)
+//---------------------------------------------------------
+{
+	std::vector<int> radius_set;
+	std::stringstream stream(radius_list);
+	std::string token;
+
+	// The radii are separated by commas, e.g. 1,3,7,15
+	while (std::getline(stream, token, ','))
+	{
+		if (token.size())
+		{
+			radius_set.push_back(atoi(token.c_str()));
+		}
+	}
+
+	if (radius_set.empty())
+	{
+		throw std::string("No radius found in \"") + radius_list + "\".";
+	}
+
+	return radius_set;
+}
+
+
+//------------------------------------------------------------------
+std::string radiusFileName(const std::string& file_name, int radius)
+//------------------------------------------------------------------
+{
+	// Insert _r<radius> before the extension
+	std::stringstream suffix;
+	suffix << "_r" << radius;
+
+	std::string::size_type extension = file_name.find_last_of('.');
+	std::string::size_type directory = file_name.find_last_of("/\\");
+
+	if (extension == std::string::npos ||
+		(directory != std::string::npos && extension < directory))
+	{
+		return file_name + suffix.str();
+	}
+
+	return file_name.substr(0, extension) + suffix.str() + file_name.substr(extension);
+}
@@ -22,8 +22,14 @@
 #include <cstdlib>   // Header for atoi and atof
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/constantTimeMedian.h" // Radius-independent median filter
+#include "../Common/imageLoader.h"        // Decode-time reduction of the image
+#include "../Common/stripStreaming.h"     // Strip-by-strip filtering of large images
+
 
 //******************************************************************************
 //	Namespaces
@@ -52,15 +58,40 @@ int main(int argc, char** argv)
 {
     try
     {
+        // Separate the options from the file names
+        std::string engine("opencv");
+        int scale_denominator(1);
+        int strip_rows(0);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (argument.find("--engine=") == 0)
+            {
+                engine = argument.substr(std::string("--engine=").size());
+            }
+            else if (!parseScaleOption(argument, scale_denominator) &&
+                !parseStreamOption(argument, strip_rows))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
         // No file to save
-        if (argc != 3 && argc != 4)
+        if ((arguments.size() != 2 && arguments.size() != 3) ||
+            (engine != "opencv" && engine != "o1") ||
+            (strip_rows && scale_denominator != 1))
         {
             // Create an error message
             std::string error_message;
             error_message  = "usage: ";
             error_message += argv[0];
-            error_message += " <input_image>  <output_image> <kernel_radius>";
+            error_message += " <input_image>  <output_image> <kernel_radius> [--engine=opencv|o1] [--scale=1|2|4|8]";
+            error_message += "\n       ";
+            error_message += argv[0];
+            error_message += " <input.pnm|tif>  <output.pnm|tif> <kernel_radius> [--engine=opencv|o1] --stream[=rows]";
 
             // Throw an error
             throw error_message;
@@ -70,9 +101,9 @@ int main(int argc, char** argv)
 		// Filter radius
 		unsigned int radius(1);
 
-		if (argc == 4)
+		if (arguments.size() == 3)
 		{
-			radius = atoi(argv[3]);
+			radius = atoi(arguments[2].c_str());
 		}
 
 		// Write your own code here
@@ -80,13 +111,38 @@ int main(int argc, char** argv)
 		//Filter Size
 		unsigned int filter_size = (radius * 2) + 1;;
 		
-		string input_filename(argv[1]);
-		string output_filename(argv[2]);
+		string input_filename(arguments[0]);
+		string output_filename(arguments[1]);
+
+		// The same filter is used in memory and in streaming mode
+		StripFilter filter = [&](const cv::Mat& src, cv::Mat& dst)
+		{
+			// The cost of the histogram-based median does not grow with the radius
+			if (engine == "o1")
+			{
+				constantTimeMedianBlur(src, dst, radius);
+			}
+			else
+			{
+				cv::medianBlur(src, dst, filter_size);
+			}
+		};
+
+		// Streaming: the image is read, filtered and written in strips of
+		// rows and is never held in memory as a whole. The output is the same
+		// as in memory, but the image is not displayed
+		if (strip_rows)
+		{
+			streamFilter(input_filename, output_filename, radius, strip_rows, filter);
+			return 0;
+		}
 
 		// Create an image instance
 
 
-		cv::Mat image = cv::imread(input_filename, CV_LOAD_IMAGE_COLOR);
+		// The image is decoded at 1/scale of its size, the radius is in
+		// pixels of the decoded image
+		cv::Mat image = loadImage(input_filename, BGR_CHANNELS, scale_denominator);
 
 		// The image has not been loaded
 		if (!image.data)
@@ -101,7 +157,7 @@ int main(int argc, char** argv)
 		}
 
 		cv::Mat filterImage;
-		cv::medianBlur(image, filterImage, filter_size);
+		filter(image, filterImage);
 		
 
 		string window_title;
@@ -119,7 +175,7 @@ int main(int argc, char** argv)
 			//image has not been writen
 			string error_message;
 			error_message = "Could not write the image \"";
-			error_message += argv[2];
+			error_message += output_filename;
 			error_message += "\".";
 
 			throw error_message;
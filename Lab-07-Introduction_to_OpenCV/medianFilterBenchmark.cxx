@@ -0,0 +1,177 @@
+/**
+********************************************************************************
+*
+*   @file       medianFilterBenchmark.cxx
+*
+*   @brief      A program to compare the runtime of cv::medianBlur with the
+*               constant-time median filter for increasing radii. It also
+*               checks that both filters produce the same image.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <cstdlib>   // Header for atoi
+#include <exception> // Header for catching exceptions
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/constantTimeMedian.h" // Radius-independent median filter
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Global variables
+//******************************************************************************
+const int g_radius_set[] = {1, 2, 3, 5, 10, 15, 20, 30, 50};
+const int g_repetitions = 3;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+double timeOpenCV(const cv::Mat& image, cv::Mat& output, int radius);
+double timeConstantTime(const cv::Mat& image, cv::Mat& output, int radius);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    try
+    {
+        // No file to process
+        if (argc != 2 && argc != 3)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "usage: ";
+            error_message += argv[0];
+            error_message += " <input_image> [max_radius]";
+
+            // Throw an error
+            throw error_message;
+        }
+
+        int max_radius(30);
+        if (argc == 3)
+        {
+            max_radius = atoi(argv[2]);
+        }
+
+        // Open and read the image
+        cv::Mat image = cv::imread(argv[1], CV_LOAD_IMAGE_COLOR);
+
+        // The image has not been loaded
+        if (!image.data)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "Could not open or find the image \"";
+            error_message += argv[1];
+            error_message += "\".";
+
+            // Throw an error
+            throw error_message;
+        }
+
+        cout << "Image: " << image.cols << "x" << image.rows << "x" << image.channels()
+             << ", threads: " << cv::getNumThreads() << endl;
+        cout << setw(8) << "radius"
+             << setw(16) << "medianBlur (ms)"
+             << setw(16) << "o1 (ms)"
+             << setw(10) << "speedup"
+             << setw(12) << "max diff" << endl;
+
+        for (unsigned int i = 0; i < sizeof(g_radius_set) / sizeof(g_radius_set[0]); ++i)
+        {
+            int radius(g_radius_set[i]);
+            if (radius > max_radius)
+            {
+                break;
+            }
+
+            cv::Mat reference, output;
+            double opencv_time(timeOpenCV(image, reference, radius));
+            double o1_time(timeConstantTime(image, output, radius));
+
+            cout << setw(8) << radius
+                 << setw(16) << fixed << setprecision(2) << opencv_time
+                 << setw(16) << o1_time
+                 << setw(10) << opencv_time / o1_time
+                 << setw(12) << setprecision(0) << cv::norm(reference, output, cv::NORM_INF) << endl;
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+
+    // Exit the program
+    return 0;
+}
+
+
+//------------------------------------------------------------------
+double timeOpenCV(const cv::Mat& image, cv::Mat& output, int radius)
+//------------------------------------------------------------------
+{
+    double best_time(1.0e30);
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        cv::medianBlur(image, output, 2 * radius + 1);
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+    return best_time;
+}
+
+
+//------------------------------------------------------------------------
+double timeConstantTime(const cv::Mat& image, cv::Mat& output, int radius)
+//------------------------------------------------------------------------
+{
+    double best_time(1.0e30);
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        constantTimeMedianBlur(image, output, radius);
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+    return best_time;
+}
@@ -21,8 +21,13 @@
 //******************************************************************************
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/bgrToGrey.h"   // SIMD BGR to greyscale conversion
+#include "../Common/imageLoader.h" // Decode-time greyscale and reduction
+
 
 //******************************************************************************
 //	Namespaces
@@ -36,15 +41,33 @@ int main(int argc, char** argv)
 {
     try
     {
+        // Separate the options from the file names
+        int scale_denominator(1);
+        bool show_input(false);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (argument == "--show-input")
+            {
+                show_input = true;
+            }
+            else if (!parseScaleOption(argument, scale_denominator))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
         // No file to save
-        if (argc != 3)
+        if (arguments.size() != 2)
         {
             // Create an error message
             std::string error_message;
             error_message  = "usage: ";
             error_message += argv[0];
-            error_message += " <input_image> <output_image>";
+            error_message += " <input_image> <output_image> [--show-input] [--scale=1|2|4|8]";
 
             // Throw an error
             throw error_message;
@@ -54,17 +77,16 @@ int main(int argc, char** argv)
 
 		
 
-		string input_filename(argv[1]);
-		string output_filename(argv[2]);
+		string input_filename(arguments[0]);
+		string output_filename(arguments[1]);
 
 		// Create an image instance
 
 
-		cv::Mat image = cv::imread(input_filename, CV_LOAD_IMAGE_COLOR);
-
-		//convert rgb image to grayscale
-		cv::Mat grey_image;
-		cv::cvtColor(image, grey_image, CV_RGB2GRAY);
+		// The colour image is only decoded if it is displayed, otherwise
+		// the decoder produces the greyscale image directly
+		cv::Mat image = loadImage(input_filename,
+			show_input ? BGR_CHANNELS : GREY_CHANNEL, scale_denominator);
 
 		// The image has not been loaded
 		if (!image.data) 
@@ -78,15 +100,29 @@ int main(int argc, char** argv)
 			throw error_message;
 		}
 
+		//convert the image to grayscale, imread returns the channels in BGR order
+		cv::Mat grey_image;
+		if (image.channels() == 3)
+		{
+			bgrToGrey(image, grey_image);
+		}
+		else
+		{
+			grey_image = image;
+		}
+
 		string window_title;
 		window_title = "Display_\"";
 		window_title += input_filename;
 		window_title += "\"";
 
-		//create window
-		cv::namedWindow(window_title, cv::WINDOW_AUTOSIZE);
-		//Show image in window
-		cv::imshow(window_title, image);
+		if (show_input)
+		{
+			//create window
+			cv::namedWindow(window_title, cv::WINDOW_AUTOSIZE);
+			//Show image in window
+			cv::imshow(window_title, image);
+		}
 
 		
 
@@ -107,7 +143,7 @@ int main(int argc, char** argv)
 			//image has not been writen
 			string error_message;
 			error_message = "Could not write the image \"";
-			error_message += argv[2];
+			error_message += output_filename;
 			error_message += "\".";
 
 			throw error_message;
@@ -0,0 +1,195 @@
+/**
+********************************************************************************
+*
+*   @file       smallKernelBenchmark.cxx
+*
+*   @brief      A program to measure the speedup of the compile-time
+*               specialised kernels (smallKernels.h) over the generic OpenCV
+*               functions, for radii 1 to 3 and the image types used by the
+*               labs: 8-bit colour images for the Lab-07 filters, and float
+*               greyscale images for the edge detectors.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <exception> // Header for catching exceptions
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/smallKernels.h" // Specialised kernels for radii 1 to 3
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Global variables
+//******************************************************************************
+const cv::Size g_size_set[] = {cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(3840, 2160)};
+const int g_repetitions = 10;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+void benchmark(const std::string& name, const cv::Mat& image, int radius);
+void printRow(const std::string& name, const cv::Mat& image, int radius,
+              double opencv_time, double small_time, double difference);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    try
+    {
+        // No argument is needed
+        if (argc != 1)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "usage: ";
+            error_message += argv[0];
+
+            // Throw an error
+            throw error_message;
+        }
+
+        cout << "Threads: " << cv::getNumThreads() << endl;
+        cout << setw(10) << "filter"
+             << setw(12) << "size"
+             << setw(8) << "type"
+             << setw(8) << "radius"
+             << setw(14) << "OpenCV (ms)"
+             << setw(14) << "small (ms)"
+             << setw(10) << "speedup"
+             << setw(12) << "max diff" << endl;
+
+        for (unsigned int i = 0; i < sizeof(g_size_set) / sizeof(g_size_set[0]); ++i)
+        {
+            // Colour image as used by meanFilter and gaussianFilter
+            cv::Mat colour_image(g_size_set[i], CV_8UC3);
+            cv::randu(colour_image, 0, 256);
+
+            // Greyscale image as used by the edge detectors
+            cv::Mat grey_image(g_size_set[i], CV_32FC1);
+            cv::randu(grey_image, 0.0, 1.0);
+
+            for (int radius = 1; radius <= 3; ++radius)
+            {
+                benchmark("mean", colour_image, radius);
+                benchmark("gaussian", colour_image, radius);
+            }
+
+            benchmark("gaussian", grey_image, 1);
+            benchmark("scharr", grey_image, 1);
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+
+    // Exit the program
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------
+void benchmark(const std::string& name, const cv::Mat& image, int radius)
+//-----------------------------------------------------------------------
+{
+    cv::Size kernel(2 * radius + 1, 2 * radius + 1);
+    cv::Mat reference, output;
+    double opencv_time(1.0e30);
+    double small_time(1.0e30);
+
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        if (name == "mean")
+        {
+            cv::blur(image, reference, kernel);
+        }
+        else if (name == "gaussian")
+        {
+            cv::GaussianBlur(image, reference, kernel, 0.5);
+        }
+        else
+        {
+            cv::Scharr(image, reference, -1, 1, 0);
+        }
+        opencv_time = std::min(opencv_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+
+        start = cv::getTickCount();
+        if (name == "mean")
+        {
+            smallKernelBlur(image, output, radius);
+        }
+        else if (name == "gaussian")
+        {
+            smallKernelGaussianBlur(image, output, radius, 0.5);
+        }
+        else
+        {
+            smallKernelScharr(image, output, 1, 0);
+        }
+        small_time = std::min(small_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+
+    printRow(name, image, radius, opencv_time, small_time, cv::norm(reference, output, cv::NORM_INF));
+}
+
+
+//-------------------------------------------------------------------------
+void printRow(const std::string& name, const cv::Mat& image, int radius,
+              double opencv_time, double small_time, double difference)
+//-------------------------------------------------------------------------
+{
+    std::string size(std::to_string(image.cols) + "x" + std::to_string(image.rows));
+    std::string type(image.depth() == CV_8U ? "8UC" : "32FC");
+    type += std::to_string(image.channels());
+
+    cout << setw(10) << name
+         << setw(12) << size
+         << setw(8) << type
+         << setw(8) << radius
+         << setw(14) << fixed << setprecision(3) << opencv_time
+         << setw(14) << small_time
+         << setw(10) << setprecision(2) << opencv_time / small_time
+         << setw(12) << setprecision(4) << difference << endl;
+}
@@ -0,0 +1,345 @@
+/**
+********************************************************************************
+*
+*   @file       cartoonQualityReport.cxx
+*
+*   @brief      A program to compare the bilateral grid (bilateralGrid.h)
+*               with the ten iterations of the bilateral filter that flatten
+*               the colours of the cartoon effect (cartoon.h). For each
+*               quality level of the grid, the runtime of the colour branch
+*               and of the whole effect is measured, and the PSNR and the
+*               SSIM of the flattened colours are computed against ten
+*               iterations of cv::bilateralFilter, run by this program and
+*               not by CartoonContext, which are the reference. The input is
+*               an image, or the first frames of a video. Each quality level
+*               has its own CartoonContext, reused by all the frames as in a
+*               video, and the buffers allocated after the first frame are
+*               counted with MatAllocationCounter, in release builds too
+*               (they should be 0).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <cmath>     // Header for log10
+#include <cstdlib>   // Header for atoi
+#include <exception> // Header for catching exceptions
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the frames
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/bilateralGrid.h"        // Fast edge-preserving smoothing
+#include "../Common/cartoon.h"              // Cartoon effect
+#include "../Common/matAllocationCounter.h" // Count the images allocated by cv::Mat
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Global variables
+//******************************************************************************
+const int g_default_frame_count = 10;
+const int g_repetitions = 3;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+void loadFrames(const std::string& file_name, int frame_count, std::vector<cv::Mat>& frame_set);
+double timeReference(const cv::Mat& small_frame, cv::Mat& reference);
+double timeColours(CartoonContext& context, const cv::Mat& small_frame, cv::Mat& smoothed);
+double timeCartoon(CartoonContext& context, const cv::Mat& frame);
+double computePSNR(const cv::Mat& reference, const cv::Mat& test);
+double computeSSIM(const cv::Mat& reference, const cv::Mat& test);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    try
+    {
+        // Count the images allocated by cv::Mat, CartoonContext only does it
+        // in debug builds
+        MatAllocationCounter::install();
+
+        // No file to process
+        if (argc != 2 && argc != 3)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "usage: ";
+            error_message += argv[0];
+            error_message += " <input_image_or_video> [frame_count]";
+
+            // Throw an error
+            throw error_message;
+        }
+
+        int frame_count(argc == 3 ? atoi(argv[2]) : g_default_frame_count);
+        if (frame_count < 1)
+        {
+            throw std::string("The number of frames must be at least 1.");
+        }
+
+        std::vector<cv::Mat> frame_set;
+        loadFrames(argv[1], frame_count, frame_set);
+
+        // The colours are flattened on frames reduced by a factor 4, as in
+        // CartoonContext::apply()
+        std::vector<cv::Mat> small_frame_set(frame_set.size());
+        std::vector<cv::Mat> reference_set(frame_set.size());
+        double reference_colour_time(0.0);
+        for (size_t i = 0; i < frame_set.size(); ++i)
+        {
+            cv::resize(frame_set[i], small_frame_set[i], cv::Size(0, 0), 0.25, 0.25, cv::INTER_AREA);
+            reference_colour_time += timeReference(small_frame_set[i], reference_set[i]);
+        }
+
+        cout << "Frames: " << frame_set.size() << " of " << frame_set[0].cols << "x" << frame_set[0].rows
+             << ", colours on " << small_frame_set[0].cols << "x" << small_frame_set[0].rows
+             << ", threads: " << cv::getNumThreads() << endl;
+        cout << setw(9) << "quality"
+             << setw(10) << "cell"
+             << setw(14) << "colours (ms)"
+             << setw(10) << "speedup"
+             << setw(14) << "cartoon (ms)"
+             << setw(10) << "fps"
+             << setw(12) << "PSNR (dB)"
+             << setw(8) << "SSIM"
+             << setw(8) << "allocs" << endl;
+
+        // Quality 0 runs the ten bilateral filters in CartoonContext, it
+        // should match the reference
+        for (int quality = 0; quality <= BILATERAL_GRID_MAX_QUALITY; ++quality)
+        {
+            CartoonContext context(quality);
+            double colour_time(0.0);
+            double cartoon_time(0.0);
+            double psnr(0.0);
+            double ssim(0.0);
+            for (size_t i = 0; i < frame_set.size(); ++i)
+            {
+                cv::Mat smoothed;
+                colour_time += timeColours(context, small_frame_set[i], smoothed);
+                cartoon_time += timeCartoon(context, frame_set[i]);
+                psnr += computePSNR(reference_set[i], smoothed);
+                ssim += computeSSIM(reference_set[i], smoothed);
+            }
+            psnr /= frame_set.size();
+            ssim /= frame_set.size();
+            long allocation_count(context.getSteadyAllocationCount());
+
+            // Quality 0 is the reference, ten bilateral filters
+            std::string cell("10 x BF");
+            if (quality > 0)
+            {
+                cell = std::to_string(BILATERAL_GRID_SAMPLING[quality - 1][0]) + "px " +
+                    std::to_string(BILATERAL_GRID_SAMPLING[quality - 1][1]) + "gl";
+            }
+
+            cout << setw(9) << quality
+                 << setw(10) << cell
+                 << setw(14) << fixed << setprecision(2) << colour_time / frame_set.size()
+                 << setw(10) << reference_colour_time / colour_time
+                 << setw(14) << cartoon_time / frame_set.size()
+                 << setw(10) << setprecision(1) << 1000.0 * frame_set.size() / cartoon_time
+                 << setw(12) << setprecision(2) << psnr
+                 << setw(8) << setprecision(4) << ssim
+                 << setw(8) << allocation_count << endl;
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+
+    // Exit the program
+    return 0;
+}
+
+
+//---------------------------------------------------------------------------------------------
+void loadFrames(const std::string& file_name, int frame_count, std::vector<cv::Mat>& frame_set)
+//---------------------------------------------------------------------------------------------
+{
+    frame_set.clear();
+
+    // An image
+    cv::Mat image = cv::imread(file_name, CV_LOAD_IMAGE_COLOR);
+    if (image.data)
+    {
+        frame_set.push_back(image);
+        return;
+    }
+
+    // The first frames of a video
+    cv::VideoCapture video_capture(file_name);
+    cv::Mat frame;
+    while (int(frame_set.size()) < frame_count && video_capture.isOpened() && video_capture.read(frame) && !frame.empty())
+    {
+        frame_set.push_back(frame.clone());
+    }
+
+    if (frame_set.empty())
+    {
+        // Create an error message
+        std::string error_message;
+        error_message  = "Could not open or find the image or the video \"";
+        error_message += file_name;
+        error_message += "\".";
+
+        // Throw an error
+        throw error_message;
+    }
+}
+
+
+//-------------------------------------------------------------------
+double timeReference(const cv::Mat& small_frame, cv::Mat& reference)
+//-------------------------------------------------------------------
+{
+    // Ten iterations of cv::bilateralFilter with the parameters of the
+    // cartoon effect, back and forth between two images
+    cv::Mat ping_pong_frames[2];
+    double best_time(1.0e30);
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        small_frame.copyTo(ping_pong_frames[0]);
+        for (int j = 0; j < 10; ++j)
+        {
+            cv::bilateralFilter(ping_pong_frames[j % 2], ping_pong_frames[(j + 1) % 2], 5, 5, 7);
+        }
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+
+    reference = ping_pong_frames[0];
+    return best_time;
+}
+
+
+//----------------------------------------------------------------------------------------
+double timeColours(CartoonContext& context, const cv::Mat& small_frame, cv::Mat& smoothed)
+//----------------------------------------------------------------------------------------
+{
+    double best_time(1.0e30);
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        context.smoothColours(small_frame);
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+
+    // The result is a buffer of the context
+    context.smoothColours(small_frame).copyTo(smoothed);
+    return best_time;
+}
+
+
+//---------------------------------------------------------------
+double timeCartoon(CartoonContext& context, const cv::Mat& frame)
+//---------------------------------------------------------------
+{
+    cv::Mat cartoon;
+    double best_time(1.0e30);
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        context.apply(frame, cartoon);
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+    return best_time;
+}
+
+
+//---------------------------------------------------------------
+double computePSNR(const cv::Mat& reference, const cv::Mat& test)
+//---------------------------------------------------------------
+{
+    double error(cv::norm(reference, test, cv::NORM_L2));
+    double mse(error * error / double(reference.total() * reference.channels()));
+
+    // Identical images
+    if (mse <= 0.0)
+    {
+        return 99.99;
+    }
+
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+
+//---------------------------------------------------------------
+double computeSSIM(const cv::Mat& reference, const cv::Mat& test)
+//---------------------------------------------------------------
+{
+    // Wang et al. (2004): 11x11 Gaussian window of sigma 1.5, averaged over
+    // the pixels and the channels
+    const double c1((0.01 * 255) * (0.01 * 255));
+    const double c2((0.03 * 255) * (0.03 * 255));
+    cv::Size window_size(11, 11);
+
+    cv::Mat x, y;
+    reference.convertTo(x, CV_32F);
+    test.convertTo(y, CV_32F);
+
+    cv::Mat mean_x, mean_y, mean_xx, mean_yy, mean_xy;
+    cv::GaussianBlur(x, mean_x, window_size, 1.5);
+    cv::GaussianBlur(y, mean_y, window_size, 1.5);
+    cv::GaussianBlur(x.mul(x), mean_xx, window_size, 1.5);
+    cv::GaussianBlur(y.mul(y), mean_yy, window_size, 1.5);
+    cv::GaussianBlur(x.mul(y), mean_xy, window_size, 1.5);
+
+    cv::Mat mean_x2(mean_x.mul(mean_x));
+    cv::Mat mean_y2(mean_y.mul(mean_y));
+    cv::Mat mean_x_y(mean_x.mul(mean_y));
+
+    cv::Mat numerator((2 * mean_x_y + c1).mul(2 * (mean_xy - mean_x_y) + c2));
+    cv::Mat denominator((mean_x2 + mean_y2 + c1).mul((mean_xx - mean_x2) + (mean_yy - mean_y2) + c2));
+
+    cv::Mat ssim_map;
+    cv::divide(numerator, denominator, ssim_map);
+
+    cv::Scalar channel_mean(cv::mean(ssim_map));
+    double sum(0.0);
+    for (int c = 0; c < reference.channels(); ++c)
+    {
+        sum += channel_mean[c];
+    }
+    return sum / reference.channels();
+}
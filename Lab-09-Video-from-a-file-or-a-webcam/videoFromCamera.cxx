@@ -26,6 +26,8 @@
 
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/cartoon.h" // Cartoon effect
+
 
 //******************************************************************************
 //    Namespaces
@@ -43,6 +45,9 @@ const int g_edge = 5; // Edge around the images in the window
 cv::Mat g_current_frame; // Store the current frame
 cv::Mat g_edge_frame;    // Store the edges detected in the current frame
 cv::Mat g_displayed_image; // The image displayed in the window
+cv::Mat g_cartoon_frame;   // The cartoon version of the current frame
+
+CartoonContext g_cartoon_context; // Buffers of the cartoon effect
 
 // The title of every window
 std::string g_window_title("Video");
@@ -234,81 +239,14 @@ void cartoonise(int, void*)
 //-------------------------
 {
 	// Copy the current frame into the large image (g_displayed_image).
-   // Add an edge of g_edge pixels around g_current_frame.
+	// Add an edge of g_edge pixels around g_current_frame.
 	cv::Mat targetROI = g_displayed_image(cv::Rect(g_edge, g_edge, g_current_frame.cols, g_current_frame.rows));
 	g_current_frame.copyTo(targetROI);
 
-	// convert the image (g_current_frame) to greyscale.
-	// save the resulting image in greyscale_frame.
-	cv::Mat greyscale_frame;
-	cv::cvtColor(g_current_frame, greyscale_frame, cv::COLOR_BGR2GRAY);
-	//cv::normalize(greyscale_frame, greyscale_frame, 0.0, 1.0, cv::NORM_MINMAX, CV_32FC1);
-
-//	// Apply a median filter on greyscale_frame with a size of 7 pixels.
-//	// Save the resulting image in median_frame.
-	cv::Mat median_frame;
-	cv::medianBlur(greyscale_frame, median_frame, 7);
-
-	//	// Perform a Laplacian filter on median_frame
-	//	// You must use unsigned char for the output, i.e. the depth is CV_8U
-	//	// The kernel size is 5x5
-	//	// Save the resulting image in edge_frame.
-	cv::Mat edge_frame;
-	cv::Laplacian(median_frame, edge_frame, CV_8U, 5);
-
-	//	// Perform an edge detection using edge_frame and the threshold function.
-	//	// The threshold is 100, the maximum value is 255, and the thresholding type is THRES_BINARY_INV (or 1).
-	//	// Save the resulting image in mask_frame.
-	cv::Mat mask_frame;
-	cv::threshold(edge_frame, mask_frame, 100, 255, CV_THRESH_BINARY_INV);
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, mask_frame.cols, mask_frame.rows));
-	//mask_frame.copyTo(targetROI);
-
-//	// Reduce the input image (g_current_frame) size by a factor 10 and resample using pixel area relation.
-	// Save the resulting image in small_frame.
-	float ds_factor = 4;
-	cv::Mat small_frame;
-#if CV_MAJOR_VERSION <= 3
-	cv::resize(g_current_frame, small_frame, cv::Size(0, 0), 1.0 / ds_factor, 1.0 / ds_factor, CV_INTER_AREA);
-#else
-	cv::resize(g_current_frame, small_frame, cv::Size(0, 0), 1.0 / ds_factor, 1.0 / ds_factor, cv::INTER_AREA);
-#endif
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, small_frame.cols, small_frame.rows));
-	//small_frame.copyTo(targetROI);
-
-
-	// Apply a bilateral filter 10 times. The kernel size is 5, sigma colour is 5, and sigma space is 7.
-	// Save the resulting image in small_frame.
-	for (int i = 0; i < 10; ++i) {
-		cv::Mat temp;
-		cv::bilateralFilter(small_frame, temp, 5, 5, 7);
-		small_frame = temp;
-	}
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, small_frame.cols, small_frame.rows));
-	//small_frame.copyTo(targetROI);
-	 // Restore the of the image (small_frame) so that it is the same as the input image (g_current_frame) and resample using bi-linear interpolation.
-	// Save the resulting image in output_frame.
-
-	cv::Mat output_frame;
-#if CV_MAJOR_VERSION <= 3
-	cv::resize(small_frame, output_frame, cv::Size(0, 0), ds_factor, ds_factor, CV_INTER_LINEAR);
-#else
-	cv::resize(small_frame, output_frame, cv::Size(0, 0), ds_factor, ds_factor, cv::INTER_LINEAR);
-#endif
-
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, output_frame.cols, output_frame.rows));
-	//output_frame.copyTo(targetROI);
-
-
-	 //add a thick boundary using a boolean operator (and).
-	// save the resulting image in cartoon_frame.
-	cv::Mat cartoon_frame;
-	cv::bitwise_and(output_frame, output_frame, cartoon_frame, mask_frame);
-
-
-	//	// copy the result
-	targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, cartoon_frame.cols, cartoon_frame.rows));
-	cartoon_frame.copyTo(targetROI);
-	//
+	// Apply the cartoon effect
+	g_cartoon_context.apply(g_current_frame, g_cartoon_frame);
 
+	// copy the result
+	targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, g_cartoon_frame.cols, g_cartoon_frame.rows));
+	g_cartoon_frame.copyTo(targetROI);
 }
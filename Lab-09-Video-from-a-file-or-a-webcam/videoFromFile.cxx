@@ -4,7 +4,15 @@
 *    @file      videoFromFile.cxx
 *
 *    @brief     A simple program using OpenCV to display a video and
-*               perform some image processing tasks.
+*               perform some image processing tasks. Decoding, processing
+*               and encoding run in their own threads, connected by bounded
+*               lock-free queues, and the frames are displayed by the main
+*               thread. The frame buffers are recycled through a pool. The
+*               occupancy of each stage is printed at the end. The frames
+*               are displayed on a presentation clock (framePacer.h), or as
+*               fast as possible with --max-throughput. With --grid=Q, the
+*               colours of the cartoon effect are flattened with a bilateral
+*               grid of quality Q instead of ten bilateral filters.
 *
 *    @version   1.0
 *
@@ -20,13 +28,21 @@
 //******************************************************************************
 //    Includes
 //******************************************************************************
-#include <exception> // Header for catching exceptions
-#include <iostream>  // Header to display text in the console
-#include <string>    // Header to manipulate strings
-#include <cmath>     // Header use round()
+#include <atomic>     // Header for the stop flag
+#include <cstdlib>    // Header for atoi
+#include <exception>  // Header for catching exceptions
+#include <functional> // Header for std::ref
+#include <iostream>   // Header to display text in the console
+#include <string>     // Header to manipulate strings
+#include <thread>     // Header for the threads of the pipeline
+#include <vector>     // Header to store the statistics of the stages
 
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/cartoon.h"       // Cartoon effect
+#include "../Common/framePacer.h"    // Presentation clock
+#include "../Common/videoPipeline.h" // Frame pool and stage statistics
+
 
 //******************************************************************************
 //    Namespaces
@@ -41,9 +57,9 @@ const double EPSILON(1.0e-5);
 
 const int g_edge = 5; // Edge around the images in the window
 
-cv::Mat g_current_frame; // Store the current frame
-cv::Mat g_edge_frame;    // Store the edges detected in the current frame
-cv::Mat g_displayed_image; // The image displayed in the window
+const int g_queue_capacity = 2; // Frames between two stages of the pipeline
+
+std::atomic<bool> g_stop(false); // Stop all the stages of the pipeline
 
 // The title of every window
 std::string g_window_title("Video");
@@ -52,7 +68,32 @@ std::string g_window_title("Video");
 //******************************************************************************
 //    Function declaration
 //******************************************************************************
-void cartoonise(int, void*);
+void decodeFrames(cv::VideoCapture& video_capture,
+                  const cv::Size& scaled_video_size,
+                  FramePool& frame_pool,
+                  VideoFrameQueueSet& output_queues,
+                  StageStatistics& statistics);
+
+void processFrames(const cv::Size& target_video_size,
+                   int grid_quality,
+                   VideoFrameQueue& input_queue,
+                   VideoFrameQueue& output_queue,
+                   StageStatistics& statistics);
+
+void encodeFrames(cv::VideoWriter& video_writer,
+                  VideoFrameQueueSet& input_queues,
+                  ReorderBuffer& reorder_buffer,
+                  VideoFrameQueue& output_queue,
+                  StageStatistics& statistics);
+
+void displayFrames(FramePacer& frame_pacer,
+                   FramePool& frame_pool,
+                   VideoFrameQueue& input_queue,
+                   StageStatistics& statistics);
+
+void joinThreads(std::vector<std::thread>& thread_set);
+
+void cartoonise(VideoFrame& frame, CartoonContext& cartoon_context);
 
 
 //******************************************************************************
@@ -80,8 +121,35 @@ int main(int argc, char** argv)
 		/* Process the command line arguments                                 */
 		/**********************************************************************/
 
+		// Separate the options from the file names
+		int worker_count(1);
+		int grid_quality(0);
+		bool max_throughput(false);
+		std::vector<std::string> arguments;
+		for (int i = 0; i < argc; ++i)
+		{
+			std::string argument(argv[i]);
+
+			if (i > 0 && argument == "--max-throughput")
+			{
+				max_throughput = true;
+			}
+			else if (i > 0 && argument.find("--grid=") == 0)
+			{
+				grid_quality = atoi(argument.substr(std::string("--grid=").size()).c_str());
+				if (grid_quality < 1 || grid_quality > BILATERAL_GRID_MAX_QUALITY)
+				{
+					throw std::string("The quality of the bilateral grid must be between 1 and 3.");
+				}
+			}
+			else if (i == 0 || !parseWorkerOption(argument, worker_count))
+			{
+				arguments.push_back(argument);
+			}
+		}
+
         // No file to display
-        if (argc != 3 && argc != 4)
+        if (arguments.size() != 3 && arguments.size() != 4)
         {
             // Create an error message
             std::string error_message;
@@ -90,27 +158,30 @@ int main(int argc, char** argv)
             error_message += " <input_video>";
             error_message += " <scaling_factor>";
             error_message += " [output_video]";
+            error_message += " [--workers=N]";
+            error_message += " [--max-throughput]";
+            error_message += " [--grid=1|2|3]";
 
             error_message += "\n\tExample: ";
             error_message += argv[0];
             error_message += " SAMPLING.AVI";
             error_message += " 0.25";
             error_message += " test.avi";
+            error_message += " --workers=4";
 
             // Throw an error
-			std::cout << error_message << endl;
-			//throw error_message;
+			throw error_message;
         }
 
 		std::cout << "2" << endl;
 		// Get the file names
-		input_file_name  = argv[1];
-        double scaling_factor = atof(argv[2]);
+		input_file_name  = arguments[1];
+        double scaling_factor = atof(arguments[2].c_str());
 
         // An output file name has been specified
-        if (argc == 4)
+        if (arguments.size() == 4)
         {
-            output_file_name = argv[3];
+            output_file_name = arguments[3];
 			std::cout << "3" << endl;
         }
 		
@@ -131,11 +202,15 @@ int main(int argc, char** argv)
 		double fps = video_capture.get(CV_CAP_PROP_FPS);
 		cout << "Frame per seconds : " << fps << endl;
 
-		// Convert in seconds per frame (default 30 ms / frame)
-		double seconds_per_frame(1.0 / fps);
+		// It may be 0 (or NaN), use a default frame rate
+		if (!(fps > 0.0))
+		{
+			fps = FRAME_PACER_DEFAULT_FPS;
+			std::cerr << "WARNING: Unknown frame rate, " << fps << " frames per second are assumed." << std::endl;
+		}
 
-		// Convert in milliseconds
-		int milliseconds_per_frame(round(seconds_per_frame * 1000.0));
+		// The frames are displayed at this rate, whatever the processing time
+		FramePacer frame_pacer(fps, max_throughput);
 
 		// Get the video size
 		cv::Size input_video_size(video_capture.get(CV_CAP_PROP_FRAME_WIDTH), video_capture.get(CV_CAP_PROP_FRAME_HEIGHT));
@@ -147,9 +222,6 @@ int main(int argc, char** argv)
 		cv::Size target_video_size(g_edge * 3 + 2 * scaled_video_size.width, g_edge * 2 + scaled_video_size.height);
 
 
-		// Create the output image
-		g_displayed_image = cv::Mat(target_video_size.height, target_video_size.width, CV_8UC3, cv::Scalar(128, 128, 128));
-
 		/**********************************************************************/
 		/* File writer                                                        */
 		/**********************************************************************/
@@ -173,143 +245,424 @@ int main(int argc, char** argv)
 				}
 			}
 		}
-		/*video_capture >> g_current_frame;
-		cartoonise(0, 0);
-		cv::imshow("frame", g_displayed_image);*/
-		int key;
-		bool input_stream_status(true);
-		do
+
+		/**********************************************************************/
+		/* Pipeline                                                           */
+		/**********************************************************************/
+
+		// The frames have no dependency between them, so they can be
+		// processed by several workers, each with its own input and output
+		// queues. OpenCV then runs each function on a single thread, to
+		// avoid running more threads than cores.
+		if (worker_count > 1)
+		{
+			cv::setNumThreads(1);
+		}
+
+		// Each thread can hold a frame, and each queue g_queue_capacity frames
+		FramePool frame_pool(worker_count + 3 + (2 * worker_count + 1) * g_queue_capacity);
+		VideoFrameQueueSet decoded_frames;
+		VideoFrameQueueSet processed_frames;
+		VideoFrameQueue encoded_frames(g_queue_capacity);
+		createQueueSet(decoded_frames, worker_count, g_queue_capacity);
+		createQueueSet(processed_frames, worker_count, g_queue_capacity);
+
+		// The frames of the workers are put back in sequence before encoding
+		ReorderBuffer reorder_buffer(frame_pool.size());
+
+		std::vector<StageStatistics> stage_set;
+		stage_set.push_back(StageStatistics("decode"));
+		for (int i = 0; i < worker_count; ++i)
 		{
-		
-			video_capture >> g_current_frame;
+			stage_set.push_back(StageStatistics(worker_count == 1 ? std::string("process") : "worker " + std::to_string(i + 1)));
+		}
+		stage_set.push_back(StageStatistics("encode"));
+		stage_set.push_back(StageStatistics("display"));
+
+		int64 start_ticks(cv::getTickCount());
+
+		std::vector<std::thread> thread_set;
+		thread_set.push_back(std::thread(decodeFrames,
+			std::ref(video_capture), scaled_video_size,
+			std::ref(frame_pool), std::ref(decoded_frames), std::ref(stage_set[0])));
+
+		for (int i = 0; i < worker_count; ++i)
+		{
+			thread_set.push_back(std::thread(processFrames,
+				target_video_size, grid_quality,
+				std::ref(*decoded_frames[i]), std::ref(*processed_frames[i]), std::ref(stage_set[1 + i])));
+		}
+
+		thread_set.push_back(std::thread(encodeFrames,
+			std::ref(video_writer),
+			std::ref(processed_frames), std::ref(reorder_buffer), std::ref(encoded_frames), std::ref(stage_set[1 + worker_count])));
+
+		// HighGUI must be used from the main thread. The threads must be
+		// joined even if an error occurs.
+		try
+		{
+			displayFrames(frame_pacer, frame_pool, encoded_frames, stage_set.back());
+		}
+		catch (...)
+		{
+			joinThreads(thread_set);
+			throw;
+		}
+
+		joinThreads(thread_set);
+
+		printStageStatistics(cout, stage_set, cv::getTickCount() - start_ticks);
+		if (worker_count > 1)
+		{
+			cout << "Frames waiting for an earlier frame: at most " << reorder_buffer.getPeakSize() << endl;
+		}
+		frame_pacer.printStatistics(cout);
+	}
+	// An error occured
+	catch (const std::exception& error)
+	{
+		// Display an error message in the console
+		cerr << error.what() << endl;
+	}
+	catch (const std::string& error)
+	{
+		// Display an error message in the console
+		cerr << error << endl;
+	}
+	catch (const char* error)
+	{
+		// Display an error message in the console
+		cerr << error << endl;
+	}
+
+	// Exit the program
+	return 0;
+}
+
+
+//------------------------------------------------------------------------------
+void decodeFrames(cv::VideoCapture& video_capture,
+                  const cv::Size& scaled_video_size,
+                  FramePool& frame_pool,
+                  VideoFrameQueueSet& output_queues,
+                  StageStatistics& statistics)
+//------------------------------------------------------------------------------
+{
+	try
+	{
+		size_t next_queue(0);
+		for (long index = 0; !g_stop; ++index)
+		{
+			int64 wait_start(cv::getTickCount());
+
+			VideoFrame* p_frame(0);
+			if (!frame_pool.acquire(p_frame, g_stop))
+			{
+				break;
+			}
 
-			if (g_current_frame.empty()) {
+			int64 work_start(cv::getTickCount());
+
+			// The buffers of the frame are reused
+			if (!video_capture.read(p_frame->captured_image) || p_frame->captured_image.empty())
+			{
 				break;
 			}
+
 			// Resize the input if needed
-			if (input_video_size != scaled_video_size)
+			if (p_frame->captured_image.size() != scaled_video_size)
 			{
-				cv::resize(g_current_frame, g_current_frame, scaled_video_size);
+				cv::resize(p_frame->captured_image, p_frame->image, scaled_video_size);
 			}
-			cartoonise(0, 0);
+			else
+			{
+				p_frame->image = p_frame->captured_image;
+			}
+			p_frame->index = index;
+
+			int64 work_end(cv::getTickCount());
+
+			// Any worker with room
+			if (!pushToAnyQueue(output_queues, p_frame, next_queue, g_stop))
+			{
+				break;
+			}
+
+			statistics.addFrame(wait_start, work_start, work_end, cv::getTickCount());
+		}
+	}
+	catch (const std::exception& error)
+	{
+		cerr << error.what() << endl;
+		g_stop = true;
+	}
+	catch (const std::string& error)
+	{
+		cerr << error << endl;
+		g_stop = true;
+	}
+	catch (...)
+	{
+		cerr << "Unknown error in the pipeline." << endl;
+		g_stop = true;
+	}
+
+	// End of the video, for every worker
+	for (size_t i = 0; i < output_queues.size(); ++i)
+	{
+		output_queues[i]->push(0, g_stop);
+	}
+}
+
+
+//------------------------------------------------------------------------------
+void processFrames(const cv::Size& target_video_size,
+                   int grid_quality,
+                   VideoFrameQueue& input_queue,
+                   VideoFrameQueue& output_queue,
+                   StageStatistics& statistics)
+//------------------------------------------------------------------------------
+{
+	try
+	{
+		// The buffers of the effect are reused by all the frames of this worker
+		CartoonContext cartoon_context(grid_quality);
+
+		VideoFrame* p_frame(0);
+		for (;;)
+		{
+			int64 wait_start(cv::getTickCount());
+
+			if (!input_queue.pop(p_frame, g_stop) || !p_frame)
+			{
+				break;
+			}
+
+			int64 work_start(cv::getTickCount());
+
+			// The grey background is only drawn when the buffer is created
+			if (p_frame->displayed_image.size() != target_video_size)
+			{
+				p_frame->displayed_image = cv::Mat(target_video_size.height, target_video_size.width, CV_8UC3, cv::Scalar(128, 128, 128));
+			}
+			cartoonise(*p_frame, cartoon_context);
+
+			int64 work_end(cv::getTickCount());
+
+			if (!output_queue.push(p_frame, g_stop))
+			{
+				break;
+			}
+
+			statistics.addFrame(wait_start, work_start, work_end, cv::getTickCount());
+		}
+	}
+	catch (const std::exception& error)
+	{
+		cerr << error.what() << endl;
+		g_stop = true;
+	}
+	catch (const std::string& error)
+	{
+		cerr << error << endl;
+		g_stop = true;
+	}
+	catch (...)
+	{
+		cerr << "Unknown error in the pipeline." << endl;
+		g_stop = true;
+	}
+
+	// End of the video
+	output_queue.push(0, g_stop);
+}
+
+
+//------------------------------------------------------------------------------
+void encodeFrames(cv::VideoWriter& video_writer,
+                  VideoFrameQueueSet& input_queues,
+                  ReorderBuffer& reorder_buffer,
+                  VideoFrameQueue& output_queue,
+                  StageStatistics& statistics)
+//------------------------------------------------------------------------------
+{
+	try
+	{
+		size_t ended_worker_count(0);
+		for (;;)
+		{
+			int64 wait_start(cv::getTickCount());
+
+			// Collect the frames of the workers until the next one in
+			// sequence is there, or all the workers have finished
+			VideoFrame* p_frame(reorder_buffer.takeNext());
+			for (int attempt = 0; !p_frame && ended_worker_count < input_queues.size() && !g_stop; ++attempt)
+			{
+				for (size_t i = 0; i < input_queues.size(); ++i)
+				{
+					VideoFrame* p_processed_frame(0);
+					if (input_queues[i]->tryPop(p_processed_frame))
+					{
+						if (p_processed_frame)
+						{
+							reorder_buffer.insert(p_processed_frame);
+						}
+						else
+						{
+							++ended_worker_count;
+						}
+						attempt = -1;
+					}
+				}
+
+				p_frame = reorder_buffer.takeNext();
+				if (!p_frame && attempt >= 0)
+				{
+					VideoFrameQueue::wait(attempt);
+				}
+			}
+
+			if (!p_frame)
+			{
+				break;
+			}
+
+			int64 work_start(cv::getTickCount());
+
 			// The file writer is working
 			if (video_writer.isOpened())
 			{
 				// Add the current frame
-				video_writer.write(g_displayed_image);
-
+				video_writer.write(p_frame->displayed_image);
 			}
 
-			cv::imshow(g_window_title, g_displayed_image);
-			key = cv::waitKey(milliseconds_per_frame);
-		} while (key != 'q' && key != 27 && input_stream_status);
+			int64 work_end(cv::getTickCount());
 
-		
-		
+			if (!output_queue.push(p_frame, g_stop))
+			{
+				break;
+			}
+
+			statistics.addFrame(wait_start, work_start, work_end, cv::getTickCount());
+		}
 	}
-	// An error occured
 	catch (const std::exception& error)
 	{
-		// Display an error message in the console
 		cerr << error.what() << endl;
+		g_stop = true;
 	}
 	catch (const std::string& error)
 	{
-		// Display an error message in the console
 		cerr << error << endl;
+		g_stop = true;
 	}
-	catch (const char* error)
+	catch (...)
 	{
-		// Display an error message in the console
-		cerr << error << endl;
+		cerr << "Unknown error in the pipeline." << endl;
+		g_stop = true;
 	}
 
-	// Exit the program
-	return 0;
+	// End of the video
+	output_queue.push(0, g_stop);
 }
-  
 
 
-//-------------------------
-void cartoonise(int, void*)
-//-------------------------
+//------------------------------------------------------------------------------
+void displayFrames(FramePacer& frame_pacer,
+                   FramePool& frame_pool,
+                   VideoFrameQueue& input_queue,
+                   StageStatistics& statistics)
+//------------------------------------------------------------------------------
 {
-	// Copy the current frame into the large image (g_displayed_image).
-   // Add an edge of g_edge pixels around g_current_frame.
-	cv::Mat targetROI = g_displayed_image(cv::Rect(g_edge, g_edge, g_current_frame.cols, g_current_frame.rows));
-	g_current_frame.copyTo(targetROI);
-
-	// convert the image (g_current_frame) to greyscale.
-	// save the resulting image in greyscale_frame.
-	cv::Mat greyscale_frame;
-	cv::cvtColor(g_current_frame, greyscale_frame, cv::COLOR_BGR2GRAY);
-	//cv::normalize(greyscale_frame, greyscale_frame, 0.0, 1.0, cv::NORM_MINMAX, CV_32FC1);
-	
-//	// Apply a median filter on greyscale_frame with a size of 7 pixels.
-//	// Save the resulting image in median_frame.
-	cv::Mat median_frame;
-	cv::medianBlur(greyscale_frame, median_frame, 7);
-	
-//	// Perform a Laplacian filter on median_frame
-//	// You must use unsigned char for the output, i.e. the depth is CV_8U
-//	// The kernel size is 5x5
-//	// Save the resulting image in edge_frame.
-	cv::Mat edge_frame;
-	cv::Laplacian(median_frame, edge_frame, CV_8U, 5);
-	
-//	// Perform an edge detection using edge_frame and the threshold function.
-//	// The threshold is 100, the maximum value is 255, and the thresholding type is THRES_BINARY_INV (or 1).
-//	// Save the resulting image in mask_frame.
-	cv::Mat mask_frame;
-	cv::threshold(edge_frame, mask_frame, 100, 255, CV_THRESH_BINARY_INV);
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, mask_frame.cols, mask_frame.rows));
-	//mask_frame.copyTo(targetROI);
-
-//	// Reduce the input image (g_current_frame) size by a factor 10 and resample using pixel area relation.
-	// Save the resulting image in small_frame.
-	float ds_factor = 4;
-	cv::Mat small_frame;
-#if CV_MAJOR_VERSION <= 3
-	cv::resize(g_current_frame, small_frame, cv::Size(0, 0), 1.0 / ds_factor, 1.0 / ds_factor, CV_INTER_AREA);
-#else
-	cv::resize(g_current_frame, small_frame, cv::Size(0, 0), 1.0 / ds_factor, 1.0 / ds_factor, cv::INTER_AREA);
-#endif
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, small_frame.cols, small_frame.rows));
-	//small_frame.copyTo(targetROI);
-
-
-	// Apply a bilateral filter 10 times. The kernel size is 5, sigma colour is 5, and sigma space is 7.
-	// Save the resulting image in small_frame.
-	for (int i = 0; i < 10; ++i) {
-		cv::Mat temp;
-		cv::bilateralFilter(small_frame, temp, 5, 5, 7);
-		small_frame = temp;
+	long expected_index(0);
+	VideoFrame* p_frame(0);
+	int key(0);
+
+	while (key != 'q' && key != 27)
+	{
+		int64 wait_start(cv::getTickCount());
+
+		if (!input_queue.pop(p_frame, g_stop) || !p_frame)
+		{
+			break;
+		}
+
+		int64 pacing_start(cv::getTickCount());
+
+		// The reorder buffer gives the frames back in sequence
+		if (p_frame->index != expected_index++)
+		{
+			throw std::string("The frames of the pipeline are out of order.");
+		}
+
+		// The previous frame stays on screen until this one is due. A late
+		// frame is dropped if the next one is ready, but it has been
+		// encoded. The end-of-stream marker is not a frame, so the last
+		// frame is never dropped.
+		VideoFrame* p_next_frame(0);
+		bool next_frame_ready(input_queue.tryPeek(p_next_frame) && p_next_frame);
+		int wait_milliseconds(0);
+		bool show(frame_pacer.schedule(wait_milliseconds, next_frame_ready));
+		key = -1;
+		if (show && wait_milliseconds > 0)
+		{
+			key = cv::waitKey(wait_milliseconds);
+		}
+
+		int64 work_start(cv::getTickCount());
+		if (show)
+		{
+			cv::imshow(g_window_title, p_frame->displayed_image);
+			frame_pacer.presented();
+
+			// Draw the window
+			int displayed_key(cv::waitKey(1));
+			if (key < 0)
+			{
+				key = displayed_key;
+			}
+		}
+
+		// The buffers of the frame can be used again
+		frame_pool.release(p_frame);
+
+		// Waiting for the presentation clock counts as blocked
+		int64 work_end(cv::getTickCount());
+		statistics.addTimes(pacing_start - wait_start, work_end - work_start, work_start - pacing_start);
 	}
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, small_frame.cols, small_frame.rows));
-	//small_frame.copyTo(targetROI);
-	 // Restore the of the image (small_frame) so that it is the same as the input image (g_current_frame) and resample using bi-linear interpolation.
-	// Save the resulting image in output_frame.
-
-	cv::Mat output_frame;
-#if CV_MAJOR_VERSION <= 3
-	cv::resize(small_frame, output_frame, cv::Size(0, 0), ds_factor ,ds_factor, CV_INTER_LINEAR);
-#else
-	cv::resize(small_frame, output_frame, cv::Size(0, 0), ds_factor, ds_factor, cv::INTER_LINEAR);
-#endif
- 
-	//targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, output_frame.cols, output_frame.rows));
-	//output_frame.copyTo(targetROI);
-	
-
-	 //add a thick boundary using a boolean operator (and).
-	// save the resulting image in cartoon_frame.
-	cv::Mat cartoon_frame;
-	cv::bitwise_and(output_frame, output_frame, cartoon_frame, mask_frame);
-
-
-//	// copy the result
-	targetROI = g_displayed_image(cv::Rect(g_edge * 2 + g_current_frame.cols, g_edge, cartoon_frame.cols, cartoon_frame.rows));
-	cartoon_frame.copyTo(targetROI);
-//
-	
+}
+
+
+//----------------------------------------------------
+void joinThreads(std::vector<std::thread>& thread_set)
+//----------------------------------------------------
+{
+	// Wake up the stages that wait for a frame or for room in a queue
+	g_stop = true;
+
+	for (size_t i = 0; i < thread_set.size(); ++i)
+	{
+		if (thread_set[i].joinable())
+		{
+			thread_set[i].join();
+		}
+	}
+}
+
+
+//-----------------------------------------------------------------
+void cartoonise(VideoFrame& frame, CartoonContext& cartoon_context)
+//-----------------------------------------------------------------
+{
+	// Copy the current frame into the large image (displayed_image).
+	// Add an edge of g_edge pixels around the frame.
+	cv::Mat targetROI = frame.displayed_image(cv::Rect(g_edge, g_edge, frame.image.cols, frame.image.rows));
+	frame.image.copyTo(targetROI);
+
+	// Apply the cartoon effect
+	cartoon_context.apply(frame.image, frame.processed_image);
+
+	// copy the result
+	targetROI = frame.displayed_image(cv::Rect(g_edge * 2 + frame.image.cols, g_edge, frame.processed_image.cols, frame.processed_image.rows));
+	frame.processed_image.copyTo(targetROI);
 }
@@ -0,0 +1,164 @@
+/**
+********************************************************************************
+*
+*   @file       cannyBenchmark.cxx
+*
+*   @brief      A program to measure how the hysteresis of the Canny edge
+*               detector (incrementalCanny.h) scales with the number of
+*               threads: serial flood fill (detect) against parallel
+*               union-find (detectParallel), from 1 thread to the number of
+*               CPUs, up to 50 megapixel images. It also checks that both
+*               give exactly the same edges.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <exception> // Header for catching exceptions
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/incrementalCanny.h" // Canny with cached gradients
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Global variables
+//******************************************************************************
+const cv::Size g_size_set[] = {cv::Size(1920, 1080), cv::Size(3840, 2160), cv::Size(8160, 6120)};
+const int g_repetitions = 5;
+const double g_low_threshold = 64;
+const double g_high_threshold = 128;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+void benchmark(const IncrementalCanny& canny, const cv::Size& size, int thread_count);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    int default_thread_count(cv::getNumThreads());
+
+    try
+    {
+        // No argument is needed
+        if (argc != 1)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "usage: ";
+            error_message += argv[0];
+
+            // Throw an error
+            throw error_message;
+        }
+
+        cout << "CPUs: " << cv::getNumberOfCPUs() << endl;
+        cout << setw(12) << "size"
+             << setw(9) << "threads"
+             << setw(13) << "serial (ms)"
+             << setw(15) << "parallel (ms)"
+             << setw(10) << "speedup"
+             << setw(8) << "equal" << endl;
+
+        for (unsigned int i = 0; i < sizeof(g_size_set) / sizeof(g_size_set[0]); ++i)
+        {
+            // Blurred noise: many edges of all lengths
+            cv::Mat noise_image(g_size_set[i], CV_8UC1);
+            cv::randu(noise_image, 0, 256);
+
+            cv::Mat grey_image;
+            cv::GaussianBlur(noise_image, grey_image, cv::Size(0, 0), 2.0);
+            cv::normalize(grey_image, grey_image, 0, 255, cv::NORM_MINMAX);
+
+            // The gradients are computed once, only the hysteresis is timed
+            IncrementalCanny canny(grey_image);
+
+            for (int thread_count = 1; thread_count <= cv::getNumberOfCPUs(); ++thread_count)
+            {
+                benchmark(canny, g_size_set[i], thread_count);
+            }
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+
+    cv::setNumThreads(default_thread_count);
+
+    // Exit the program
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------------
+void benchmark(const IncrementalCanny& canny, const cv::Size& size, int thread_count)
+//-----------------------------------------------------------------------------------
+{
+    cv::setNumThreads(thread_count);
+
+    cv::Mat serial_edges, parallel_edges;
+    double serial_time(1.0e30);
+    double parallel_time(1.0e30);
+
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        canny.detect(g_low_threshold, g_high_threshold, serial_edges);
+        serial_time = std::min(serial_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+
+        start = cv::getTickCount();
+        canny.detectParallel(g_low_threshold, g_high_threshold, parallel_edges);
+        parallel_time = std::min(parallel_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+
+    std::string size_string(std::to_string(size.width) + "x" + std::to_string(size.height));
+    bool equal(cv::norm(serial_edges, parallel_edges, cv::NORM_INF) == 0);
+
+    cout << setw(12) << size_string
+         << setw(9) << thread_count
+         << setw(13) << fixed << setprecision(3) << serial_time
+         << setw(15) << parallel_time
+         << setw(10) << setprecision(2) << serial_time / parallel_time
+         << setw(8) << (equal ? "yes" : "NO") << endl;
+}
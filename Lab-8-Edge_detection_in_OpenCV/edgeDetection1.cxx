@@ -22,8 +22,14 @@
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
 #include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 
+#include "../Common/edgeMapIO.h"       // Compact binary edge maps
+#include "../Common/imageLoader.h"     // Decode-time greyscale and reduction
+#include "../Common/pointOperation.h"  // Lookup tables and contrast stretch
+#include "../Common/scharrMagnitude.h" // Fused Gaussian and Scharr gradient magnitude
+
 
 //******************************************************************************
 //    Namespaces
@@ -63,9 +69,10 @@ int main(int argc, char** argv)
         // Image structures
         cv::Mat rgb_image;        
         cv::Mat grey_image;
-        cv::Mat gaussian_image;
         cv::Mat scharr_image;
+        cv::Mat direction_image;
         cv::Mat edge_image;
+        cv::Mat display_image;
         
         // The title of every window
         std::string grey_image_window_title("Original data");
@@ -77,8 +84,27 @@ int main(int argc, char** argv)
 		/* Process the command line arguments                                 */
 		/**********************************************************************/
 
+        // Separate the options from the file names
+        // The edges are detected in fixed point unless --float is given
+        int scale_denominator(1);
+        bool use_float(false);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (argument == "--float")
+            {
+                use_float = true;
+            }
+            else if (!parseScaleOption(argument, scale_denominator))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
-        if (argc != 3)
+        if (arguments.size() != 2)
         {
             // Create an error message
             std::string error_message;
@@ -86,14 +112,16 @@ int main(int argc, char** argv)
             error_message += argv[0];
             error_message += " <input_image>";
             error_message += " <output_image>";
+            error_message += " [--scale=1|2|4|8]";
+            error_message += " [--float]";
 
             // Throw an error
             throw error_message;
         }
 
 		// Get the file names
-		input_file_name  = argv[1];
-		output_file_name = argv[2];
+		input_file_name  = arguments[0];
+		output_file_name = arguments[1];
 
 
 		/**********************************************************************/
@@ -102,7 +130,8 @@ int main(int argc, char** argv)
 		
 		
         // Open and read the image
-        rgb_image = cv::imread(input_file_name, CV_LOAD_IMAGE_COLOR);
+        // Only the greyscale image is used, let the decoder produce it
+        rgb_image = loadImage(input_file_name, GREY_CHANNEL, scale_denominator);
 
         // The image has not been loaded
         if (!rgb_image.data)
@@ -123,13 +152,19 @@ int main(int argc, char** argv)
 				
 		// Write your own code here to
         
-        // 1) Convert the image from RGB to greyscale
-		cv::cvtColor(rgb_image, grey_image,cv::COLOR_RGB2GRAY);
+        // Decoded in greyscale (a BGR image would also be converted to grey).
+        // Stretch the grey levels from 0 to 1, as the cv::normalize
+        // (NORM_MINMAX) of the original program, with a lookup table: in 8
+        // bits (1 is 255) for the fixed-point pipeline, or in float
+        if (use_float)
+        {
+            contrastStretchFloat(rgb_image, grey_image);
+        }
+        else
+        {
+            applyPointOperation(rgb_image, PointOperation::contrastStretch(), grey_image);
+        }
 
-        // 2) Convert the image from unsigned char to float
-		grey_image.convertTo(grey_image, CV_32FC1);
-        // 3) Normalise the image
-		cv::normalize(grey_image, grey_image, 0.0, 1.0, cv::NORM_MINMAX, CV_32FC1);
         // Create the first window
         cv::namedWindow(grey_image_window_title, cv::WINDOW_AUTOSIZE);
                 
@@ -139,41 +174,20 @@ int main(int argc, char** argv)
         
         
 		/**********************************************************************/
-		/* Apply a 3x3 Gaussian filter with sigma 0.5 to reduce noise         */
+		/* 3x3 Gaussian filter with sigma 0.5 and gradient filter             */
 		/**********************************************************************/
-		cv::Size kernel(3, 3);
-		cv::GaussianBlur(grey_image, gaussian_image, kernel, 0.5);
-		// Write your own code here
-		
-		
-		/**********************************************************************/
-		/* Gradient filter                                                    */
-		/**********************************************************************/
-		
-		// Write your own code here to:
-        
-        // 1) Apply the Scharr filter on gaussain_image along the X-axis
-        cv::Mat scharr_x;
-		cv::Scharr(gaussian_image, scharr_x, -1, 1, 0);
-        // 2) Compute the absolute value of the gradient along the X-axis
-		scharr_x = cv::abs(scharr_x);
-		
-        // 3) Apply the Scharr filter on gaussain_image along the Y-axis
-        cv::Mat scharr_y;
-		cv::Scharr(gaussian_image, scharr_y, -1, 0, 1);
-        // 4) Compute the absolute value of the gradient along the Y-axis
-		scharr_y = cv::abs(scharr_y);
-		// 5) Combined scharr_x and scharr_y together so that
-		//scharr_image = 0.5 * scharr_x + 0.5 * scharr_y;
-		
-		cv::addWeighted(scharr_x, 0.5, scharr_y, 0.5, 0, scharr_image);
+
+		// scharr_image = 0.5 * |Scharr_x| + 0.5 * |Scharr_y| of the blurred image,
+		// in a single pass (CV_16SC1 in grey levels for an 8-bit image)
+		scharrMagnitude(grey_image, scharr_image, true, &direction_image);
 		
         // Create the second window
         cv::namedWindow(filtered_image_window_title, cv::WINDOW_AUTOSIZE);
                 
         // Display the second window
         // Replace rgb_image by scharr_image
-        cv::imshow(filtered_image_window_title, scharr_image);
+        scharr_image.convertTo(display_image, CV_32FC1, getUnitScale(scharr_image));
+        cv::imshow(filtered_image_window_title, display_image);
 
 
 		/**********************************************************************/
@@ -193,7 +207,8 @@ int main(int argc, char** argv)
                 
         // Display the third window
         // Replace rgb_image by edge_image
-        cv::imshow(edge_image_window_title, edge_image);
+        edge_image.convertTo(display_image, CV_32FC1, getUnitScale(edge_image));
+        cv::imshow(edge_image_window_title, display_image);
         
         // Wait for the user to press 'q' or 'Escape' (27 in ASCII code
         int key;
@@ -208,9 +223,9 @@ int main(int argc, char** argv)
 		/**********************************************************************/
 		
 		// Write your own code here
-		cv::normalize(edge_image, edge_image, 0, 255, cv::NORM_MINMAX, CV_32FC1);
-
-		cv::imwrite(output_file_name, edge_image);
+		// The format is given by the extension: .pbm, .rle, .csv (with the
+		// gradient) or any image format
+		writeEdgeMap(output_file_name, edge_image, scharr_image, direction_image);
 
 
 
@@ -4,6 +4,12 @@
 *   @file       edgeDetection2.cxx
 *
 *   @brief      A more user friendly program using OpenCV to detect edges.
+*               With --sweep, the program runs without display and exports
+*               the edge maps of all the slider positions at once: the
+*               output image is the 16-bit level of every pixel (the edge
+*               map of position p is level > p), and a CSV file with the
+*               same base name gives the number of edge pixels of every
+*               position.
 *
 *   @version    1.0
 *
@@ -22,9 +28,18 @@
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
 #include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 #include <algorithm>
 
+#include "../Common/edgeMapIO.h"           // Compact binary edge maps
+#include "../Common/imageLoader.h"         // Decode-time greyscale and reduction
+#include "../Common/latestWinsWorker.h"    // Slider callbacks in the background
+#include "../Common/panelCompositor.h"     // 8-bit canvas of the side-by-side panels
+#include "../Common/pointOperation.h"      // Lookup tables and contrast stretch
+#include "../Common/scharrMagnitude.h"     // Fused Gaussian and Scharr gradient magnitude
+#include "../Common/thresholdStatistics.h" // Histogram and rank image for the slider
+
 //******************************************************************************
 //    Namespaces
 //******************************************************************************
@@ -34,22 +49,32 @@ using namespace std;
 //******************************************************************************
 //    Global variables
 //******************************************************************************
-cv::Mat g_display_image;        
+PanelCompositor g_compositor;
 cv::Mat g_scharr_image;
+cv::Mat g_direction_image;
 cv::Mat g_edge_image;
+ThresholdStatistics g_threshold_statistics;
 std::string g_image_window_title("Edge detection");
         
-int g_slider_count(256);
+// One slider position per level of the cached statistics
+const int g_slider_count(ThresholdStatistics::LEVEL_COUNT);
 int g_slider_position(g_slider_count / 2);
 
 int N = 3;
 int k = 10;
 
+// The thresholds are applied in the background, with a preview at the size
+// of the panel. Declared last, so that its thread stops first
+cv::Mat g_preview_rank_image;
+LatestWinsWorker<int, cv::Mat> g_worker;
+
 
 //******************************************************************************
 //    Function declaration
 //******************************************************************************
 void callback(int, void*);
+bool computeEdges(const int& slider_position, bool preview, cv::Mat& edge_image);
+void displayEdges();
 
 
 //******************************************************************************
@@ -74,7 +99,6 @@ int main(int argc, char** argv)
         // Image structures
         cv::Mat rgb_image;
         cv::Mat grey_image;
-		cv::Mat gaussian_image;
                 
         
 
@@ -82,8 +106,32 @@ int main(int argc, char** argv)
 		/* Process the command line arguments                                 */
 		/**********************************************************************/
 
+        // Separate the options from the file names
+        // The edges are detected in fixed point unless --float is given
+        int scale_denominator(1);
+        bool sweep(false);
+        bool use_float(false);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (argument == "--sweep")
+            {
+                sweep = true;
+            }
+            else if (argument == "--float")
+            {
+                use_float = true;
+            }
+            else if (!parseScaleOption(argument, scale_denominator))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
         // No file to display
-        if (argc != 3)
+        if (arguments.size() != 2)
         {
             // Create an error message
             std::string error_message;
@@ -91,6 +139,9 @@ int main(int argc, char** argv)
             error_message += argv[0];
             error_message += " <input_image>";
             error_message += " <output_image>";
+            error_message += " [--scale=1|2|4|8]";
+            error_message += " [--sweep]";
+            error_message += " [--float]";
 
             // Throw an error
             throw error_message;
@@ -98,8 +149,8 @@ int main(int argc, char** argv)
 
 
 		// Get the file names
-		input_file_name  = argv[1];
-		output_file_name = argv[2];
+		input_file_name  = arguments[0];
+		output_file_name = arguments[1];
 
 
 		/**********************************************************************/
@@ -107,7 +158,8 @@ int main(int argc, char** argv)
 		/**********************************************************************/
 		
         // Open and read the image
-        rgb_image = cv::imread(input_file_name, CV_LOAD_IMAGE_COLOR);
+        // Only the greyscale image is used, let the decoder produce it
+        rgb_image = loadImage(input_file_name, GREY_CHANNEL, scale_denominator);
 
         // The image has not been loaded
         if (!rgb_image.data)
@@ -123,59 +175,95 @@ int main(int argc, char** argv)
         }
 
 		// Write your own code here to
-		// Create the displayed image
-		g_display_image = cv::Mat (rgb_image.rows, rgb_image.cols * N + (N - 1) * k, CV_32FC1, cv::Scalar(0.5, 0.5, 0.5));
+		// Create the displayed image, downscaled to fit on the screen
+		g_compositor.create(N, rgb_image.size(), k);
 		
 	    // Create the window
-		cv::namedWindow(g_image_window_title, cv::WINDOW_AUTOSIZE);
+		if (!sweep)
+		{
+			cv::namedWindow(g_image_window_title, cv::WINDOW_AUTOSIZE);
+		}
 
        
 		/**********************************************************************/
 		/* Convert the RGB data to greyscale                                  */
 		/**********************************************************************/
-		cv::cvtColor(rgb_image, grey_image, cv::COLOR_RGB2GRAY);
-		grey_image.convertTo(grey_image, CV_32FC1);
-		cv::normalize(grey_image, grey_image, 0.0, 1.0, cv::NORM_MINMAX, CV_32FC1);
-		// Create the ROI in the target image
-        cv::Mat targetROI = g_display_image(cv::Rect(0, 0, grey_image.cols, grey_image.rows));
-
-		// Copy the source in the target
-        grey_image.copyTo(targetROI);
+		// Decoded in greyscale (a BGR image would also be converted to grey).
+		// Stretch the grey levels from 0 to 1, as the cv::normalize
+		// (NORM_MINMAX) of the original program, with a lookup table: in 8
+		// bits (1 is 255) for the fixed-point pipeline, or in float
+		if (use_float)
+		{
+			contrastStretchFloat(rgb_image, grey_image);
+		}
+		else
+		{
+			applyPointOperation(rgb_image, PointOperation::contrastStretch(), grey_image);
+		}
+
+		// Copy the source in the first panel
+		g_compositor.setPanel(0, grey_image, 255.0 * getUnitScale(grey_image));
 
         
 		/**********************************************************************/
-		/* Apply a 3x3 Gaussian filter with sigma 0.5 to reduce noise         */
+		/* 3x3 Gaussian filter with sigma 0.5 and gradient filter             */
 		/**********************************************************************/
-		cv::Size kernel(3, 3);
-		cv::GaussianBlur(grey_image, gaussian_image, kernel, 0.5);
-        
-        
-        
-        
-        /**********************************************************************/
-		/* Gradient filter                                                    */
-		/**********************************************************************/
-		cv::Mat scharr_x;
-		cv::Scharr(gaussian_image, scharr_x, -1, 1, 0);
-		// 2) Compute the absolute value of the gradient along the X-axis
-		scharr_x = cv::abs(scharr_x);
-
-		// 3) Apply the Scharr filter on gaussain_image along the Y-axis
-		cv::Mat scharr_y;
-		cv::Scharr(gaussian_image, scharr_y, -1, 0, 1);
-		// 4) Compute the absolute value of the gradient along the Y-axis
-		scharr_y = cv::abs(scharr_y);
-		// 5) Combined scharr_x and scharr_y together so that
-		//scharr_image = 0.5 * scharr_x + 0.5 * scharr_y;
 
-		cv::addWeighted(scharr_x, 0.5, scharr_y, 0.5, 0, g_scharr_image);
+		// g_scharr_image = 0.5 * |Scharr_x| + 0.5 * |Scharr_y| of the blurred
+		// image, in a single pass (CV_16SC1 in grey levels for an 8-bit image)
+		scharrMagnitude(grey_image, g_scharr_image, true, &g_direction_image);
 
 
 		// Copy the result
-        targetROI = g_display_image(cv::Rect(g_scharr_image.cols * 1 + 1 * k, 0, g_scharr_image.cols, g_scharr_image.rows));
-        g_scharr_image.copyTo(targetROI);
+		g_compositor.setPanel(1, g_scharr_image, 255.0 * getUnitScale(g_scharr_image));
+
+		// g_scharr_image does not change, compute its statistics once
+		g_threshold_statistics.setImage(g_scharr_image);
+
+
+		/**********************************************************************/
+		/* Export all the slider positions                                    */
+		/**********************************************************************/
+		if (sweep)
+		{
+			// The levels need 16 bits (0 to g_slider_count), e.g. PNG or TIFF
+			cv::Mat level_image;
+			g_threshold_statistics.getLevelImage(level_image);
+
+			if (!cv::imwrite(output_file_name, level_image))
+			{
+				throw std::string("Could not write the image \"") + output_file_name + "\".";
+			}
+
+			// Curve of the edge counts, next to the image
+			std::string curve_file_name(output_file_name);
+			std::string::size_type extension = curve_file_name.find_last_of('.');
+			if (extension != std::string::npos &&
+				(curve_file_name.find_last_of("/\\") == std::string::npos ||
+				 extension > curve_file_name.find_last_of("/\\")))
+			{
+				curve_file_name = curve_file_name.substr(0, extension);
+			}
+			curve_file_name += ".csv";
+			g_threshold_statistics.writeCurve(curve_file_name);
+
+			return 0;
+		}
         
       
+		/**********************************************************************/
+		/* Start the background thread                                        */
+		/**********************************************************************/
+
+		// The previews only make sense if the panel is reduced
+		if (g_compositor.getDisplayScale() < 1.0)
+		{
+			cv::resize(g_threshold_statistics.getRankImage(), g_preview_rank_image,
+			           g_compositor.getDisplayPanelSize(), 0, 0, cv::INTER_NEAREST);
+		}
+		g_worker.start(computeEdges);
+
+
 		/**********************************************************************/
 		/* Create the slider                                                  */
 		/**********************************************************************/
@@ -195,13 +283,19 @@ int main(int argc, char** argv)
 		/**********************************************************************/
        
         // Wait for the user to press 'q' or 'Escape' (27 in ASCII code
+        // The edges are displayed as soon as they are computed
         int key;
         do
         {
-            key = cv::waitKey(0);
+            key = cv::waitKey(20);
+            displayEdges();
         }
         while (key != 'q' && key != 27);
 
+        // Edges of the last position of the slider
+        g_worker.waitUntilIdle();
+        displayEdges();
+
 
 		/**********************************************************************/
 		/* Write the output                                                   */
@@ -209,9 +303,9 @@ int main(int argc, char** argv)
 
 		// Write your own code here to
 		// Write the image
-		cv::normalize(g_edge_image, g_edge_image, 0, 255, cv::NORM_MINMAX, CV_32FC1);
-
-		cv::imwrite(output_file_name, g_edge_image);
+		// The format is given by the extension: .pbm, .rle, .csv (with the
+		// gradient) or any image format
+		writeEdgeMap(output_file_name, g_edge_image, g_scharr_image, g_direction_image);
 
 
     }
@@ -245,27 +339,70 @@ int main(int argc, char** argv)
 //-----------------------
 void callback(int, void*)
 //-----------------------
+{
+	// Only post the position, the thresholds are applied in the background
+	g_worker.post(g_slider_position);
+}
+
+
+//------------------------------------------------------------------------------
+bool computeEdges(const int& slider_position, bool preview, cv::Mat& edge_image)
+//------------------------------------------------------------------------------
 {
 	/**********************************************************************/
 	/* Threshold                                                          */
 	/**********************************************************************/
-    double min, max;
-    cv::minMaxLoc(g_scharr_image, &min, &max);
-    
-	// Linear interpolation    
-	double threshold(min + (max - min) * (double(g_slider_position) / double(g_slider_count)));
+	// Preview on the reduced rank image
+	if (preview)
+	{
+		if (g_preview_rank_image.empty())
+		{
+			return false;
+		}
+
+		g_threshold_statistics.thresholdRank(slider_position, g_preview_rank_image, edge_image);
+		return true;
+	}
 
-			
 	// Write your own code here to
-	// Find edges using a threshold filter
-	cv::threshold(g_scharr_image, g_edge_image, threshold, 255, 0);
+	// Find edges using a threshold filter (lookup table on the rank image).
+	// A stale request stops at the next strip
+	return g_threshold_statistics.threshold(slider_position, edge_image, [] { return g_worker.isCancelled(); });
+}
+
+
+//-----------------
+void displayEdges()
+//-----------------
+{
+	cv::Mat edge_image;
+	int slider_position;
+	bool preview;
+
+	if (!g_worker.takeResult(edge_image, &slider_position, &preview))
+	{
+		return;
+	}
+
+	if (!preview)
+	{
+		g_edge_image = edge_image;
+
+		// Linear interpolation between the min and the max of g_scharr_image,
+		// displayed in the units of the float pipeline
+		double threshold(g_threshold_statistics.getThreshold(slider_position) * getUnitScale(g_scharr_image));
+
+		// The number of edge pixels is read from the histogram
+		int edge_pixel_count(g_threshold_statistics.getPassCount(slider_position));
+		cout << "Threshold: " << threshold << ", edge pixels: " << edge_pixel_count
+		     << " (" << 100.0 * edge_pixel_count / g_edge_image.total() << "%)" << endl;
+	}
 
 	// Write your own code here to
 	// Copy the result
-	cv::Mat targetROI = g_display_image(cv::Rect(g_edge_image.cols*2 + 2 * k,0, g_edge_image.cols, g_edge_image.rows));
-	g_edge_image.copyTo(targetROI);
+	// Only this panel has changed
+	g_compositor.setPanel(2, edge_image);
 	// Write your own code here to
     // Display the window
-	cv::imshow(g_image_window_title, g_display_image);
+	g_compositor.show(g_image_window_title);
 }
-
@@ -22,9 +22,19 @@
 #include <exception> // Header for catching exceptions
 #include <iostream>  // Header to display text in the console
 #include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
 #include <opencv2/opencv.hpp> // Main OpenCV header
 #include <algorithm>
 
+#include "../Common/edgeMapIO.h"        // Compact binary edge maps
+#include "../Common/imageLoader.h"      // Decode-time greyscale and reduction
+#include "../Common/incrementalCanny.h" // Canny with cached gradients
+#include "../Common/latestWinsWorker.h" // Slider callbacks in the background
+#include "../Common/panelCompositor.h"  // 8-bit canvas of the side-by-side panels
+#include "../Common/pointOperation.h"   // Lookup tables and contrast stretch
+#include "../Common/pyramidEdges.h"     // Coarse-to-fine Canny
+#include "../Common/scharrMagnitude.h"  // 3x3 Gaussian and fused Scharr gradient magnitude
+
 //******************************************************************************
 //    Namespaces
 //******************************************************************************
@@ -34,10 +44,14 @@ using namespace std;
 //******************************************************************************
 //    Global variables
 //******************************************************************************
-cv::Mat g_display_image;
+PanelCompositor g_compositor;
 cv::Mat g_scharr_image;
+cv::Mat g_direction_image;
 cv::Mat g_edge_image;
-cv::Mat g_gaussian_image;
+IncrementalCanny g_canny;
+
+// With --pyramid, the tiles of g_canny near the edges of the reduced image
+PyramidCanny g_pyramid_canny;
 std::string g_image_window_title("Edge detection");
 
 int g_slider_count(256);
@@ -46,11 +60,20 @@ int g_high_slider_position(g_slider_count / 2);
 int N = 3;
 int k = 10;
 
+// The hysteresis runs in the background, with a preview on the blurred image
+// reduced to the size of the panel. Declared last, so that its thread stops
+// first
+IncrementalCanny g_preview_canny;
+LatestWinsWorker<cv::Vec2d, cv::Mat> g_worker;
+
 
 //******************************************************************************
 //    Function declaration
 //******************************************************************************
 void callback(int, void*);
+cv::Vec2d getThresholds();
+bool computeEdges(const cv::Vec2d& thresholds, bool preview, cv::Mat& edge_image);
+void displayEdges();
 
 
 //******************************************************************************
@@ -75,6 +98,7 @@ int main(int argc, char** argv)
 		// Image structures
 		cv::Mat rgb_image;
 		cv::Mat grey_image;
+		cv::Mat gaussian_image;
 
 
 
@@ -83,8 +107,30 @@ int main(int argc, char** argv)
 		/* Process the command line arguments                                 */
 		/**********************************************************************/
 
+		// Separate the options from the file names
+		// The edges are detected in fixed point unless --float is given, at
+		// full resolution unless --pyramid is given
+		int scale_denominator(1);
+		int pyramid_level_count(0);
+		bool use_float(false);
+		std::vector<std::string> arguments;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string argument(argv[i]);
+
+			if (argument == "--float")
+			{
+				use_float = true;
+			}
+			else if (!parseScaleOption(argument, scale_denominator) &&
+			         !parsePyramidOption(argument, pyramid_level_count))
+			{
+				arguments.push_back(argument);
+			}
+		}
+
 		// No file to display
-		if (argc != 3)
+		if (arguments.size() != 2)
 		{
 			// Create an error message
 			std::string error_message;
@@ -92,6 +138,9 @@ int main(int argc, char** argv)
 			error_message += argv[0];
 			error_message += " <input_image>";
 			error_message += " <output_image>";
+			error_message += " [--scale=1|2|4|8]";
+			error_message += " [--float]";
+			error_message += " [--pyramid=0|1|2|3|4]";
 
 			// Throw an error
 			throw error_message;
@@ -99,8 +148,8 @@ int main(int argc, char** argv)
 
 
 		// Get the file names
-		input_file_name = argv[1];
-		output_file_name = argv[2];
+		input_file_name = arguments[0];
+		output_file_name = arguments[1];
 
 
 		/**********************************************************************/
@@ -108,7 +157,8 @@ int main(int argc, char** argv)
 		/**********************************************************************/
 
 		// Open and read the image
-		rgb_image = cv::imread(input_file_name, CV_LOAD_IMAGE_COLOR);
+		// Only the greyscale image is used, let the decoder produce it
+		rgb_image = loadImage(input_file_name, GREY_CHANNEL, scale_denominator);
 
 		// The image has not been loaded
 		if (!rgb_image.data)
@@ -124,8 +174,8 @@ int main(int argc, char** argv)
 		}
 
 		// Write your own code here to
-		// Create the displayed image
-		g_display_image = cv::Mat(rgb_image.rows, rgb_image.cols * N + (N - 1) * k, CV_32FC1, cv::Scalar(0.5, 0.5, 0.5));
+		// Create the displayed image, downscaled to fit on the screen
+		g_compositor.create(N, rgb_image.size(), k);
 
 		// Create the window
 		cv::namedWindow(g_image_window_title, cv::WINDOW_AUTOSIZE);
@@ -134,21 +184,38 @@ int main(int argc, char** argv)
 		/**********************************************************************/
 		/* Convert the RGB data to greyscale                                  */
 		/**********************************************************************/
-		cv::cvtColor(rgb_image, grey_image, cv::COLOR_RGB2GRAY);
-		grey_image.convertTo(grey_image, CV_32FC1);
-		cv::normalize(grey_image, grey_image, 0.0, 1.0, cv::NORM_MINMAX, CV_32FC1);
-		// Create the ROI in the target image
-		cv::Mat targetROI = g_display_image(cv::Rect(0, 0, grey_image.cols, grey_image.rows));
+		// Decoded in greyscale (a BGR image would also be converted to grey).
+		// Stretch the grey levels from 0 to 1, as the cv::normalize
+		// (NORM_MINMAX) of the original program, with a lookup table: in 8
+		// bits (1 is 255) for the fixed-point pipeline, or in float
+		if (use_float)
+		{
+			contrastStretchFloat(rgb_image, grey_image);
+		}
+		else
+		{
+			applyPointOperation(rgb_image, PointOperation::contrastStretch(), grey_image);
+		}
 
-		// Copy the source in the target
-		grey_image.copyTo(targetROI);
+		// Copy the source in the first panel
+		g_compositor.setPanel(0, grey_image, 255.0 * getUnitScale(grey_image));
 
 
 		/**********************************************************************/
 		/* Apply a 3x3 Gaussian filter with sigma 0.5 to reduce noise         */
 		/**********************************************************************/
-		cv::Size kernel(3, 3);
-		cv::GaussianBlur(grey_image, g_gaussian_image, kernel, 0.5);
+		// With --pyramid, the filter and the gradients are only computed in
+		// the tiles near the edges found in the reduced image, for the low
+		// threshold of the slider
+		if (pyramid_level_count)
+		{
+			g_pyramid_canny.setImage(grey_image, pyramid_level_count, getThresholds()[0], g_canny);
+			gaussian_image = g_pyramid_canny.getBlurredImage();
+		}
+		else
+		{
+			gaussianBlur3x3(grey_image, gaussian_image);
+		}
 
 
 
@@ -156,25 +223,65 @@ int main(int argc, char** argv)
 		/**********************************************************************/
 		/* Gradient filter                                                    */
 		/**********************************************************************/
-		cv::Mat scharr_x;
-		cv::Scharr(g_gaussian_image, scharr_x, -1, 1, 0);
-		// 2) Compute the absolute value of the gradient along the X-axis
-		scharr_x = cv::abs(scharr_x);
+		// g_scharr_image = 0.5 * |Scharr_x| + 0.5 * |Scharr_y|, in a single pass
+		// (CV_16SC1 in grey levels for an 8-bit image). With --pyramid, only
+		// in the tiles of the first mask, it is 0 elsewhere
+		if (pyramid_level_count)
+		{
+			scharrMagnitude(gaussian_image, g_scharr_image, g_pyramid_canny.getTileSet(), false, &g_direction_image);
+		}
+		else
+		{
+			scharrMagnitude(gaussian_image, g_scharr_image, false, &g_direction_image);
+		}
 
-		// 3) Apply the Scharr filter on gaussain_image along the Y-axis
-		cv::Mat scharr_y;
-		cv::Scharr(g_gaussian_image, scharr_y, -1, 0, 1);
-		// 4) Compute the absolute value of the gradient along the Y-axis
-		scharr_y = cv::abs(scharr_y);
-		// 5) Combined scharr_x and scharr_y together so that
-		//scharr_image = 0.5 * scharr_x + 0.5 * scharr_y;
 
-		cv::addWeighted(scharr_x, 0.5, scharr_y, 0.5, 0, g_scharr_image);
+		// Copy the result
+		g_compositor.setPanel(1, g_scharr_image, 255.0 * getUnitScale(g_scharr_image));
 
 
-		// Copy the result
-		targetROI = g_display_image(cv::Rect(g_scharr_image.cols * 1 + 1 * k, 0, g_scharr_image.cols, g_scharr_image.rows));
-		g_scharr_image.copyTo(targetROI);
+		/**********************************************************************/
+		/* Gradients and non-maximum suppression of Canny                     */
+		/**********************************************************************/
+		// They do not depend on the thresholds, the slider callback only
+		// runs the hysteresis. The fixed-point images are already in 8 bits,
+		// only the float ones are converted. With --pyramid, they have been
+		// computed with the mask
+		if (pyramid_level_count)
+		{
+			cout << "Gradients computed on " << 100.0 * g_canny.getActivePixelCount() / grey_image.total()
+			     << "% of the image" << endl;
+		}
+		else
+		{
+			cv::Mat gaussian_8bit_image(gaussian_image);
+			if (gaussian_image.type() != CV_8UC1)
+			{
+				gaussian_image.convertTo(gaussian_8bit_image, CV_8UC1, 255);
+			}
+			g_canny.setImage(gaussian_8bit_image);
+		}
+
+
+		/**********************************************************************/
+		/* Start the background thread                                        */
+		/**********************************************************************/
+
+		// The previews only make sense if the panel is reduced. The image
+		// is reduced before the Gaussian filter, which may only have been
+		// applied near the edges
+		if (g_compositor.getDisplayScale() < 1.0)
+		{
+			cv::Mat preview_image;
+			cv::resize(grey_image, preview_image, g_compositor.getDisplayPanelSize(), 0, 0, cv::INTER_AREA);
+			if (preview_image.type() != CV_8UC1)
+			{
+				preview_image.convertTo(preview_image, CV_8UC1, 255);
+			}
+			gaussianBlur3x3(preview_image, preview_image);
+			g_preview_canny.setImage(preview_image);
+		}
+		g_worker.start(computeEdges);
 
 
 		/**********************************************************************/
@@ -198,12 +305,27 @@ int main(int argc, char** argv)
 		/**********************************************************************/
 
 		// Wait for the user to press 'q' or 'Escape' (27 in ASCII code
+		// The edges are displayed as soon as they are computed
 		int key;
 		do
 		{
-			key = cv::waitKey(0);
+			key = cv::waitKey(20);
+			displayEdges();
 		} while (key != 'q' && key != 27);
 
+		// Edges of the last position of the sliders
+		g_worker.waitUntilIdle();
+		displayEdges();
+
+		// With --pyramid, the mask may have grown since the gradient was
+		// computed, when the low threshold went down: compute it again in
+		// the tiles of the last mask, for the .csv file. The worker is idle,
+		// g_pyramid_canny can be read
+		if (pyramid_level_count)
+		{
+			scharrMagnitude(g_pyramid_canny.getBlurredImage(), g_scharr_image, g_pyramid_canny.getTileSet(), false, &g_direction_image);
+		}
+
 
 		/**********************************************************************/
 		/* Write the output                                                   */
@@ -211,9 +333,9 @@ int main(int argc, char** argv)
 
 		// Write your own code here to
 		// Write the image
-		cv::normalize(g_edge_image, g_edge_image, 0, 255, cv::NORM_MINMAX, CV_32FC1);
-
-		cv::imwrite(output_file_name, g_edge_image);
+		// The format is given by the extension: .pbm, .rle, .csv (with the
+		// gradient) or any image format
+		writeEdgeMap(output_file_name, g_edge_image, g_scharr_image, g_direction_image);
 
 
 	}
@@ -251,26 +373,81 @@ void callback(int, void*)
 	/**********************************************************************/
 	/* Threshold                                                          */
 	/**********************************************************************/
-	double min, max;
-	cv::minMaxLoc(g_scharr_image, &min, &max);
-
 	//canny edge detector
 
+	// Only post the thresholds, the edges are detected in the background
+	g_worker.post(getThresholds());
+}
+
+
+//-----------------------
+cv::Vec2d getThresholds()
+//-----------------------
+{
 	double low_thresh(255 * (double(std::min(g_low_slider_position, g_high_slider_position) / double(g_slider_count))));
 	double high_thresh(255 * (double(std::max(g_low_slider_position, g_high_slider_position) / double(g_slider_count))));
 
-	cv::Mat grey_image;
-	g_gaussian_image.convertTo(grey_image, CV_8UC1, 255);
-	cv::Canny(grey_image, g_edge_image, low_thresh, high_thresh);
-	g_edge_image.convertTo(g_edge_image, CV_32FC1, 1.0 / 255.0);
+	return cv::Vec2d(low_thresh, high_thresh);
+}
+
+
+//-------------------------------------------------------------------------------
+bool computeEdges(const cv::Vec2d& thresholds, bool preview, cv::Mat& edge_image)
+//-------------------------------------------------------------------------------
+{
+	// Preview on the reduced image
+	if (preview)
+	{
+		if (g_preview_canny.getSuppressedMagnitude().empty())
+		{
+			return false;
+		}
+
+		g_preview_canny.detect(thresholds[0], thresholds[1], edge_image);
+		return true;
+	}
+
+	// A stale request stops at the next tile or strip
+	std::function<bool()> is_cancelled([] { return g_worker.isCancelled(); });
 
+	// With --pyramid, a lower threshold may need a larger mask. Only
+	// g_canny and the buffers of g_pyramid_canny are updated, which only
+	// this thread uses once it has started. main computes the gradient of
+	// the new tiles when the worker is idle
+	g_pyramid_canny.update(thresholds[0], g_canny, is_cancelled);
+	if (is_cancelled())
+	{
+		return false;
+	}
+
+	// Hysteresis only, the gradients are cached in g_canny. The parallel
+	// version gives the same edges and scales on large images
+	return g_canny.detectParallel(thresholds[0], thresholds[1], edge_image, is_cancelled);
+}
+
+
+//-----------------
+void displayEdges()
+//-----------------
+{
+	cv::Mat edge_image;
+	bool preview;
+
+	if (!g_worker.takeResult(edge_image, 0, &preview))
+	{
+		return;
+	}
+
+	if (!preview)
+	{
+		g_edge_image = edge_image;
+	}
 
 	// Write your own code here to
 	// Copy the result
-	cv::Mat targetROI = g_display_image(cv::Rect(g_edge_image.cols * 2 + 2 * k, 0, g_edge_image.cols, g_edge_image.rows));
-	g_edge_image.copyTo(targetROI);
+	// Only this panel has changed
+	g_compositor.setPanel(2, edge_image);
 	// Write your own code here to
 	// Display the window
-	cv::imshow(g_image_window_title, g_display_image);
+	g_compositor.show(g_image_window_title);
 }
-
@@ -0,0 +1,195 @@
+/**
+********************************************************************************
+*
+*   @file       gradientBenchmark.cxx
+*
+*   @brief      A program to measure the speedup of the fused gradient
+*               magnitude (scharrMagnitude.h) over the sequence of filters it
+*               replaces in the edge detectors: 3x3 Gaussian filter, Scharr
+*               filters along X and Y, absolute values and weighted sum.
+*               The fused kernel is timed in float and in fixed point (8-bit
+*               image, 16-bit magnitude), with the largest difference of the
+*               fixed-point magnitude in the units of the float pipeline.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <exception> // Header for catching exceptions
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/scharrMagnitude.h" // Fused Gaussian and Scharr gradient magnitude
+#include "../Common/smallKernels.h"    // Specialised 3x3 Gaussian and Scharr kernels
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Global variables
+//******************************************************************************
+const cv::Size g_size_set[] = {cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(3840, 2160)};
+const int g_repetitions = 10;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+void benchmark(const cv::Mat& image, const cv::Mat& image_8bit, bool gaussian, bool direction);
+void unfusedMagnitude(const cv::Mat& image, cv::Mat& magnitude, bool gaussian);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    try
+    {
+        // No argument is needed
+        if (argc != 1)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "usage: ";
+            error_message += argv[0];
+
+            // Throw an error
+            throw error_message;
+        }
+
+        cout << "Threads: " << cv::getNumThreads() << endl;
+        cout << setw(12) << "size"
+             << setw(10) << "gaussian"
+             << setw(11) << "direction"
+             << setw(15) << "unfused (ms)"
+             << setw(13) << "fused (ms)"
+             << setw(10) << "speedup"
+             << setw(12) << "max diff"
+             << setw(13) << "fixed (ms)"
+             << setw(10) << "speedup"
+             << setw(12) << "fixed diff" << endl;
+
+        for (unsigned int i = 0; i < sizeof(g_size_set) / sizeof(g_size_set[0]); ++i)
+        {
+            // Greyscale image as used by the edge detectors, in 8 bits and
+            // in float
+            cv::Mat grey_8bit_image(g_size_set[i], CV_8UC1);
+            cv::randu(grey_8bit_image, 0, 256);
+
+            cv::Mat grey_image;
+            grey_8bit_image.convertTo(grey_image, CV_32FC1, 1.0 / 255.0);
+
+            benchmark(grey_image, grey_8bit_image, true, false);
+            benchmark(grey_image, grey_8bit_image, false, false);
+            benchmark(grey_image, grey_8bit_image, false, true);
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+
+    // Exit the program
+    return 0;
+}
+
+
+//--------------------------------------------------------------------------------------------
+void benchmark(const cv::Mat& image, const cv::Mat& image_8bit, bool gaussian, bool direction)
+//--------------------------------------------------------------------------------------------
+{
+    cv::Mat reference, output, output_8bit, direction_image;
+    double unfused_time(1.0e30);
+    double fused_time(1.0e30);
+    double fixed_time(1.0e30);
+
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        unfusedMagnitude(image, reference, gaussian);
+        unfused_time = std::min(unfused_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+
+        start = cv::getTickCount();
+        scharrMagnitude(image, output, gaussian, direction ? &direction_image : 0);
+        fused_time = std::min(fused_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+
+        start = cv::getTickCount();
+        scharrMagnitude<FixedPointPrecision>(image_8bit, output_8bit, gaussian, direction ? &direction_image : 0);
+        fixed_time = std::min(fixed_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+
+    // Fixed-point magnitude in the units of the float pipeline
+    cv::Mat fixed_output;
+    output_8bit.convertTo(fixed_output, CV_32FC1, getUnitScale(output_8bit));
+
+    std::string size(std::to_string(image.cols) + "x" + std::to_string(image.rows));
+
+    cout << setw(12) << size
+         << setw(10) << (gaussian ? "yes" : "no")
+         << setw(11) << (direction ? "yes" : "no")
+         << setw(15) << fixed << setprecision(3) << unfused_time
+         << setw(13) << fused_time
+         << setw(10) << setprecision(2) << unfused_time / fused_time
+         << setw(12) << setprecision(4) << cv::norm(reference, output, cv::NORM_INF)
+         << setw(13) << setprecision(3) << fixed_time
+         << setw(10) << setprecision(2) << fused_time / fixed_time
+         << setw(12) << setprecision(4) << cv::norm(reference, fixed_output, cv::NORM_INF) << endl;
+}
+
+
+//----------------------------------------------------------------------------
+void unfusedMagnitude(const cv::Mat& image, cv::Mat& magnitude, bool gaussian)
+//----------------------------------------------------------------------------
+{
+    // The code of the edge detectors before the fused kernel
+    cv::Mat gaussian_image;
+    if (gaussian)
+    {
+        smallKernelGaussianBlur(image, gaussian_image, 1, 0.5);
+    }
+    else
+    {
+        gaussian_image = image;
+    }
+
+    cv::Mat scharr_x, scharr_y;
+    smallKernelScharr(gaussian_image, scharr_x, 1, 0);
+    smallKernelScharr(gaussian_image, scharr_y, 0, 1);
+    scharr_x = cv::abs(scharr_x);
+    scharr_y = cv::abs(scharr_y);
+    cv::addWeighted(scharr_x, 0.5, scharr_y, 0.5, 0, magnitude);
+}
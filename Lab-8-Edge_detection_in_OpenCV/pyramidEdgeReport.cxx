@@ -0,0 +1,211 @@
+/**
+********************************************************************************
+*
+*   @file       pyramidEdgeReport.cxx
+*
+*   @brief      A program to compare the coarse-to-fine Canny edges
+*               (pyramidEdges.h) with the full resolution edges of
+*               edgeDetection3, for an image and 0 (full resolution) to 4
+*               pyramid levels. For each level and pair of thresholds, it
+*               reports the fraction of the image whose gradients were
+*               computed, the time, the speedup, the recall (fraction of the
+*               full resolution edge pixels that are found) and the precision
+*               (fraction of the pixels found that are full resolution edge
+*               pixels).
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min
+#include <exception> // Header for catching exceptions
+#include <iomanip>   // Header to format the table
+#include <iostream>  // Header to display text in the console
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/imageLoader.h"     // Decode-time greyscale and reduction
+#include "../Common/pointOperation.h"  // Lookup tables and contrast stretch
+#include "../Common/pyramidEdges.h"    // Coarse-to-fine Canny
+#include "../Common/scharrMagnitude.h" // 3x3 Gaussian filter
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Global variables
+//******************************************************************************
+
+/// Thresholds of edgeDetection3 for slider positions (32, 64) and (64, 128)
+const double g_threshold_set[][2] = {{31.875, 63.75}, {63.75, 127.5}};
+const int g_repetitions = 5;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+double detectEdges(const cv::Mat& grey_image,
+                   const cv::Mat& blurred_image,
+                   int level_count,
+                   double low_threshold,
+                   double high_threshold,
+                   cv::Mat& edges,
+                   double& active_fraction);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    try
+    {
+        // Separate the options from the file names
+        int scale_denominator(1);
+        std::vector<std::string> arguments;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (!parseScaleOption(argument, scale_denominator))
+            {
+                arguments.push_back(argument);
+            }
+        }
+
+        // One image is needed
+        if (arguments.size() != 1)
+        {
+            // Create an error message
+            std::string error_message;
+            error_message  = "usage: ";
+            error_message += argv[0];
+            error_message += " <input_image>";
+            error_message += " [--scale=1|2|4|8]";
+
+            // Throw an error
+            throw error_message;
+        }
+
+        cv::Mat input_image = loadImage(arguments[0], GREY_CHANNEL, scale_denominator);
+        if (!input_image.data)
+        {
+            throw std::string("Could not open or find the image \"") + arguments[0] + "\".";
+        }
+
+        // Same pipeline as edgeDetection3 in fixed point
+        cv::Mat grey_image, blurred_image;
+        applyPointOperation(input_image, PointOperation::contrastStretch(), grey_image);
+        gaussianBlur3x3(grey_image, blurred_image);
+
+        cout << "Image: " << grey_image.cols << "x" << grey_image.rows << endl;
+        cout << setw(8) << "levels"
+             << setw(9) << "low"
+             << setw(9) << "high"
+             << setw(10) << "active"
+             << setw(11) << "time (ms)"
+             << setw(10) << "speedup"
+             << setw(13) << "edge pixels"
+             << setw(9) << "recall"
+             << setw(11) << "precision" << endl;
+
+        for (unsigned int i = 0; i < sizeof(g_threshold_set) / sizeof(g_threshold_set[0]); ++i)
+        {
+            double low_threshold(g_threshold_set[i][0]);
+            double high_threshold(g_threshold_set[i][1]);
+
+            // Full resolution reference
+            cv::Mat reference_edges;
+            double active_fraction;
+            double reference_time(detectEdges(grey_image, blurred_image, 0, low_threshold, high_threshold, reference_edges, active_fraction));
+            int reference_count(cv::countNonZero(reference_edges));
+
+            for (int level_count = 0; level_count <= PYRAMID_EDGE_MAX_LEVEL_COUNT; ++level_count)
+            {
+                cv::Mat edges;
+                double time(detectEdges(grey_image, blurred_image, level_count, low_threshold, high_threshold, edges, active_fraction));
+
+                cv::Mat common_edges;
+                cv::bitwise_and(edges, reference_edges, common_edges);
+                int edge_count(cv::countNonZero(edges));
+                int common_count(cv::countNonZero(common_edges));
+
+                cout << setw(8) << level_count
+                     << setw(9) << fixed << setprecision(2) << low_threshold
+                     << setw(9) << high_threshold
+                     << setw(9) << setprecision(1) << 100.0 * active_fraction << "%"
+                     << setw(11) << setprecision(3) << time
+                     << setw(10) << setprecision(2) << reference_time / time
+                     << setw(13) << edge_count
+                     << setw(9) << setprecision(4) << (reference_count ? double(common_count) / reference_count : 1.0)
+                     << setw(11) << (edge_count ? double(common_count) / edge_count : 1.0) << endl;
+            }
+        }
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+    }
+
+    // Exit the program
+    return 0;
+}
+
+
+//------------------------------------------------------------------------------
+double detectEdges(const cv::Mat& grey_image,
+                   const cv::Mat& blurred_image,
+                   int level_count,
+                   double low_threshold,
+                   double high_threshold,
+                   cv::Mat& edges,
+                   double& active_fraction)
+//------------------------------------------------------------------------------
+{
+    // Best time of the gradients, the coarse level included, and the
+    // hysteresis
+    double best_time(1.0e30);
+    IncrementalCanny canny;
+
+    for (int i = 0; i < g_repetitions; ++i)
+    {
+        int64 start(cv::getTickCount());
+        setPyramidImage(canny, grey_image, blurred_image, level_count, 0, getPyramidMaskMagnitude(low_threshold));
+        canny.detectParallel(low_threshold, high_threshold, edges);
+        best_time = std::min(best_time, 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency());
+    }
+
+    active_fraction = double(canny.getActivePixelCount()) / grey_image.total();
+    return best_time;
+}
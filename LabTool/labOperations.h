@@ -0,0 +1,382 @@
+/**
+********************************************************************************
+*
+*   @file       labOperations.h
+*
+*   @brief      The image processing operations of the labs, wrapped with a
+*               common signature so that labtool can run any of them by
+*               name: greyscale conversion, log scale, mean, Gaussian and
+*               median filters, edge detection and cartoon effect. The
+*               parameters of an operation are given as key=value pairs,
+*               e.g. r=2 for the radius of a filter.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef LAB_OPERATIONS_H
+#define LAB_OPERATIONS_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <algorithm> // Header for std::min and std::max
+#include <cstdlib>   // Header for atoi and atof
+#include <map>       // Header to store the parameters
+#include <set>       // Header to store the parameters that have been read
+#include <string>    // Header to manipulate strings
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/bgrToGrey.h"          // SIMD BGR to greyscale conversion
+#include "../Common/cartoon.h"            // Cartoon effect
+#include "../Common/constantTimeMedian.h" // Radius-independent median filter
+#include "../Common/imageLoader.h"        // Channels needed by the operations
+#include "../Common/pointOperation.h"     // Lookup-table point operations
+#include "../Common/recursiveGaussian.h"  // Sigma-independent Gaussian filter
+#include "../Common/slidingBoxFilter.h"   // Radius-independent mean filter
+#include "../Common/smallKernels.h"       // Specialised kernels for radii 1 to 3
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Parameters of an operation, as key=value pairs.
+class OperationParameters
+{
+public:
+    void set(const std::string& key, const std::string& value)
+    {
+        m_value_set[key] = value;
+    }
+
+    /// Parse "key=value".
+    void set(const std::string& key_value);
+
+    std::string getString(const std::string& key, const std::string& default_value) const;
+    int getInt(const std::string& key, int default_value) const;
+    double getDouble(const std::string& key, double default_value) const;
+
+    /// Throw an error if a parameter has not been read by the operation,
+    /// e.g. because of a typo in its key.
+    void checkAllRead(const std::string& operation_name) const;
+
+private:
+    std::map<std::string, std::string> m_value_set;
+    mutable std::set<std::string> m_read_key_set;
+};
+
+
+/// Signature of the operations. src and dst may be the same image.
+typedef void (*OperationFunction)(const cv::Mat& src,
+                                  cv::Mat& dst,
+                                  const OperationParameters& parameters);
+
+
+/// An operation that can be run by name.
+struct Operation
+{
+    const char* name;
+    const char* description;
+    ImageChannels input_channels; ///< What has to be decoded from the file
+    OperationFunction function;
+};
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+
+/// Greyscale conversion (8-bit).
+inline void greyOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters);
+
+/// Log scale of the greyscale image, normalised between its min and max.
+inline void logOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters);
+
+/// Mean filter. r: radius (1), engine: opencv|sliding (opencv).
+inline void meanOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters);
+
+/// Gaussian filter. r: radius (1), sigma: standard deviation (0, i.e.
+/// computed from the radius as in cv::getGaussianKernel, 0.8 for r=1),
+/// engine: fir|iir (fir).
+inline void gaussianOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters);
+
+/// Median filter. r: radius (1), engine: opencv|o1 (opencv).
+inline void medianOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters);
+
+/// Canny edges of the greyscale image after a 3x3 Gaussian filter, as in
+/// edgeDetection3. low and high: thresholds in [0, 255] (64 and 128).
+inline void edgesOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters);
+
+/// Cartoon effect of Lab-09. grid: 0 for ten bilateral filters, 1 to 3 for
+/// a bilateral grid, from the fastest to the closest (0).
+inline void cartoonOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters);
+
+/// The operations, terminated by an entry whose name is null.
+inline const Operation* getOperationSet();
+
+/// The operation called name, or null.
+inline const Operation* findOperation(const std::string& name);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//----------------------------------------------------------------
+inline void OperationParameters::set(const std::string& key_value)
+//----------------------------------------------------------------
+{
+    std::string::size_type equal = key_value.find('=');
+
+    if (equal == std::string::npos || equal == 0)
+    {
+        throw std::string("Invalid parameter \"") + key_value + "\", the syntax is key=value.";
+    }
+
+    set(key_value.substr(0, equal), key_value.substr(equal + 1));
+}
+
+
+//------------------------------------------------------------------------------
+inline std::string OperationParameters::getString(const std::string& key,
+                                                  const std::string& default_value) const
+//------------------------------------------------------------------------------
+{
+    m_read_key_set.insert(key);
+
+    std::map<std::string, std::string>::const_iterator ite = m_value_set.find(key);
+    return ite == m_value_set.end() ? default_value : ite->second;
+}
+
+
+//-------------------------------------------------------------------------------------
+inline int OperationParameters::getInt(const std::string& key, int default_value) const
+//-------------------------------------------------------------------------------------
+{
+    m_read_key_set.insert(key);
+
+    std::map<std::string, std::string>::const_iterator ite = m_value_set.find(key);
+    return ite == m_value_set.end() ? default_value : atoi(ite->second.c_str());
+}
+
+
+//----------------------------------------------------------------------------------------------
+inline double OperationParameters::getDouble(const std::string& key, double default_value) const
+//----------------------------------------------------------------------------------------------
+{
+    m_read_key_set.insert(key);
+
+    std::map<std::string, std::string>::const_iterator ite = m_value_set.find(key);
+    return ite == m_value_set.end() ? default_value : atof(ite->second.c_str());
+}
+
+
+//------------------------------------------------------------------------------------
+inline void OperationParameters::checkAllRead(const std::string& operation_name) const
+//------------------------------------------------------------------------------------
+{
+    for (std::map<std::string, std::string>::const_iterator ite = m_value_set.begin();
+        ite != m_value_set.end();
+        ++ite)
+    {
+        if (m_read_key_set.find(ite->first) == m_read_key_set.end())
+        {
+            throw std::string("Unknown parameter \"") + ite->first + "\" for \"" + operation_name + "\".";
+        }
+    }
+}
+
+
+//------------------------------------------------------------------------------------------------
+inline void greyOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters)
+//------------------------------------------------------------------------------------------------
+{
+    // No parameter
+    (void)parameters;
+
+    if (src.channels() == 3)
+    {
+        bgrToGrey(src, dst);
+    }
+    // Already greyscale (e.g. decoded in greyscale)
+    else if (src.data != dst.data)
+    {
+        dst = src;
+    }
+}
+
+
+//-----------------------------------------------------------------------------------------------
+inline void logOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters)
+//-----------------------------------------------------------------------------------------------
+{
+    // No parameter
+    (void)parameters;
+
+    applyPointOperation(src, PointOperation::logScale(), dst);
+}
+
+
+//------------------------------------------------------------------------------------------------
+inline void meanOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters)
+//------------------------------------------------------------------------------------------------
+{
+    int radius(parameters.getInt("r", 1));
+    std::string engine(parameters.getString("engine", "opencv"));
+
+    // The cost of the sliding sums does not grow with the radius
+    if (engine == "sliding")
+    {
+        slidingBoxFilter(src, dst, radius);
+    }
+    // Specialised kernels for radii 1 to 3, cv::blur otherwise
+    else if (engine == "opencv")
+    {
+        smallKernelBlur(src, dst, radius);
+    }
+    else
+    {
+        throw std::string("Unknown engine \"") + engine + "\" for \"mean\" (opencv|sliding).";
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------
+inline void gaussianOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters)
+//----------------------------------------------------------------------------------------------------
+{
+    int radius(parameters.getInt("r", 1));
+    double sigma(parameters.getDouble("sigma", 0.0));
+    std::string engine(parameters.getString("engine", "fir"));
+
+    // The recursive filter ignores the radius, its support is infinite.
+    // Without sigma, it uses the sigma of the FIR kernel of this radius
+    // (the rule of cv::getGaussianKernel)
+    if (engine == "iir")
+    {
+        if (sigma <= 0.0)
+        {
+            sigma = 0.3 * (radius - 1) + 0.8;
+        }
+        recursiveGaussianBlur(src, dst, sigma);
+    }
+    // Specialised kernels for radii 1 to 3, cv::GaussianBlur otherwise
+    else if (engine == "fir")
+    {
+        smallKernelGaussianBlur(src, dst, radius, sigma);
+    }
+    else
+    {
+        throw std::string("Unknown engine \"") + engine + "\" for \"gaussian\" (fir|iir).";
+    }
+}
+
+
+//--------------------------------------------------------------------------------------------------
+inline void medianOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters)
+//--------------------------------------------------------------------------------------------------
+{
+    int radius(parameters.getInt("r", 1));
+    std::string engine(parameters.getString("engine", "opencv"));
+
+    // The cost of the histogram-based median does not grow with the radius
+    if (engine == "o1")
+    {
+        constantTimeMedianBlur(src, dst, radius);
+    }
+    else if (engine == "opencv")
+    {
+        cv::medianBlur(src, dst, 2 * radius + 1);
+    }
+    else
+    {
+        throw std::string("Unknown engine \"") + engine + "\" for \"median\" (opencv|o1).";
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+inline void edgesOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters)
+//-------------------------------------------------------------------------------------------------
+{
+    double low_threshold(parameters.getDouble("low", 64.0));
+    double high_threshold(parameters.getDouble("high", 128.0));
+
+    cv::Mat grey_image;
+    greyOperation(src, grey_image, parameters);
+
+    // 3x3 Gaussian filter with sigma 0.5 to reduce noise
+    cv::Mat gaussian_image;
+    smallKernelGaussianBlur(grey_image, gaussian_image, 1, 0.5);
+
+    cv::Canny(gaussian_image, dst, std::min(low_threshold, high_threshold), std::max(low_threshold, high_threshold));
+}
+
+
+//---------------------------------------------------------------------------------------------------
+inline void cartoonOperation(const cv::Mat& src, cv::Mat& dst, const OperationParameters& parameters)
+//---------------------------------------------------------------------------------------------------
+{
+    if (src.channels() != 3)
+    {
+        throw std::string("\"cartoon\" needs a colour image.");
+    }
+
+    int grid_quality(parameters.getInt("grid", 0));
+    if (grid_quality < 0 || grid_quality > BILATERAL_GRID_MAX_QUALITY)
+    {
+        throw std::string("\"cartoon\" needs a grid quality between 0 and 3.");
+    }
+
+    // The frame is read before the output is written, so dst may be src
+    cartooniseFrame(src, dst, grid_quality);
+}
+
+
+//---------------------------------------
+inline const Operation* getOperationSet()
+//---------------------------------------
+{
+    static const Operation operation_set[] =
+    {
+        {"grey",     "greyscale conversion",                             GREY_CHANNEL, greyOperation},
+        {"log",      "log scale",                                        GREY_CHANNEL, logOperation},
+        {"mean",     "mean filter [r=1] [engine=opencv|sliding]",        BGR_CHANNELS, meanOperation},
+        {"gaussian", "Gaussian filter [r=1] [sigma=0] [engine=fir|iir]", BGR_CHANNELS, gaussianOperation},
+        {"median",   "median filter [r=1] [engine=opencv|o1]",           BGR_CHANNELS, medianOperation},
+        {"edges",    "Canny edges [low=64] [high=128]",                  GREY_CHANNEL, edgesOperation},
+        {"cartoon",  "cartoon effect",                                   BGR_CHANNELS, cartoonOperation},
+        {0, 0, BGR_CHANNELS, 0}
+    };
+
+    return operation_set;
+}
+
+
+//------------------------------------------------------------
+inline const Operation* findOperation(const std::string& name)
+//------------------------------------------------------------
+{
+    for (const Operation* p_operation = getOperationSet(); p_operation->name; ++p_operation)
+    {
+        if (name == p_operation->name)
+        {
+            return p_operation;
+        }
+    }
+
+    return 0;
+}
+
+
+#endif // LAB_OPERATIONS_H
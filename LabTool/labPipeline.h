@@ -0,0 +1,153 @@
+/**
+********************************************************************************
+*
+*   @file       labPipeline.h
+*
+*   @brief      A chain of lab operations run in memory, e.g.
+*               "grey,log,gaussian:r=2,edges": the stages are separated by
+*               commas and the parameters of a stage by colons. The image is
+*               decoded once before the first stage and encoded once after
+*               the last one; in between, the stages read from and write to
+*               two buffers in turn, so no intermediate file is written and
+*               the buffers are reused whenever two stages produce images of
+*               the same size and type.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+#ifndef LAB_PIPELINE_H
+#define LAB_PIPELINE_H
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <sstream>   // Header to split the description of the pipeline
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the stages
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "labOperations.h" // Operations that can be run by name
+
+
+//******************************************************************************
+//    Class declaration
+//******************************************************************************
+
+/// Operations applied one after the other to an image.
+class OperationPipeline
+{
+public:
+    /// Parse a description such as "grey,log,gaussian:r=2,edges".
+    explicit OperationPipeline(const std::string& description);
+
+    /// Channels to decode for the first stage.
+    ImageChannels getInputChannels() const
+    {
+        return m_stage_set.front().p_operation->input_channels;
+    }
+
+    /// Set a parameter ("key=value") of the last stage.
+    void setParameter(const std::string& key_value)
+    {
+        m_stage_set.back().parameters.set(key_value);
+    }
+
+    /// Run all the stages. The reference returned stays valid until the next
+    /// call.
+    const cv::Mat& run(const cv::Mat& input);
+
+private:
+    struct Stage
+    {
+        const Operation* p_operation;
+        OperationParameters parameters;
+    };
+
+    std::vector<Stage> m_stage_set;
+    cv::Mat m_buffer_set[2];
+};
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-------------------------------------------------------------------------
+inline OperationPipeline::OperationPipeline(const std::string& description)
+//-------------------------------------------------------------------------
+{
+    std::stringstream stage_stream(description);
+    std::string stage_description;
+
+    while (std::getline(stage_stream, stage_description, ','))
+    {
+        // name[:key=value[:key=value ...]]
+        std::stringstream parameter_stream(stage_description);
+        std::string name;
+        std::getline(parameter_stream, name, ':');
+
+        Stage stage;
+        stage.p_operation = findOperation(name);
+
+        if (!stage.p_operation)
+        {
+            throw std::string("Unknown operation \"") + name + "\" in \"" + description + "\".";
+        }
+
+        std::string key_value;
+        while (std::getline(parameter_stream, key_value, ':'))
+        {
+            stage.parameters.set(key_value);
+        }
+
+        m_stage_set.push_back(stage);
+    }
+
+    if (m_stage_set.empty())
+    {
+        throw std::string("The pipeline \"") + description + "\" has no operation.";
+    }
+}
+
+
+//----------------------------------------------------------------
+inline const cv::Mat& OperationPipeline::run(const cv::Mat& input)
+//----------------------------------------------------------------
+{
+    // Each stage reads the output of the previous one and writes in the
+    // other buffer
+    const cv::Mat* p_source(&input);
+    cv::Mat* p_target(0);
+
+    for (unsigned int i = 0; i < m_stage_set.size(); ++i)
+    {
+        p_target = &m_buffer_set[i % 2];
+
+        // A buffer may share the data of the input (e.g. "grey" on a
+        // greyscale image), it must not be overwritten
+        if (p_target->data == input.data)
+        {
+            p_target->release();
+        }
+
+        m_stage_set[i].p_operation->function(*p_source, *p_target, m_stage_set[i].parameters);
+        m_stage_set[i].parameters.checkAllRead(m_stage_set[i].p_operation->name);
+
+        p_source = p_target;
+    }
+
+    return *p_target;
+}
+
+
+#endif // LAB_PIPELINE_H
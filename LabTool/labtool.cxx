@@ -0,0 +1,332 @@
+/**
+********************************************************************************
+*
+*   @file       labtool.cxx
+*
+*   @brief      A single program that runs the operations of the labs (grey,
+*               log, mean, gaussian, median, edges, cartoon) as subcommands.
+*               The run subcommand chains several operations in memory,
+*               e.g. "run grey,log,gaussian:r=2,edges in.png out.png", so
+*               the image is decoded and encoded only once.
+*               With --headless, HighGUI is never used, so the program can
+*               run without a display. The batch subcommand runs one command
+*               per line of a job file in the same process, so OpenCV is
+*               initialised once for all the jobs. labtool is also a
+*               multi-call binary: if it is called through a link named
+*               after an operation (e.g. "median"), it runs that operation.
+*
+*   @version    1.0
+*
+*   @date       18/10/2026
+*
+*   @author     Franck Vidal
+*
+*
+********************************************************************************
+*/
+
+
+//******************************************************************************
+//    Includes
+//******************************************************************************
+#include <cstdlib>   // Header for EXIT_SUCCESS and EXIT_FAILURE
+#include <exception> // Header for catching exceptions
+#include <fstream>   // Header to read the job files
+#include <iostream>  // Header to display text in the console
+#include <sstream>   // Header to split the lines of the job files
+#include <string>    // Header to manipulate strings
+#include <vector>    // Header to store the command line arguments
+#include <opencv2/opencv.hpp> // Main OpenCV header
+
+#include "../Common/imageLoader.h" // Decode-time greyscale and reduction
+#include "labOperations.h"         // Operations that can be run by name
+#include "labPipeline.h"           // Operations chained in memory
+
+
+//******************************************************************************
+//    Namespaces
+//******************************************************************************
+using namespace std;
+
+
+//******************************************************************************
+//    Function declaration
+//******************************************************************************
+std::string getUsage(const std::string& program_name);
+std::string getBaseName(const std::string& path);
+void runCommand(const std::vector<std::string>& argument_set, bool headless);
+int runBatch(const std::string& job_file_name);
+
+
+//******************************************************************************
+//    Implementation
+//******************************************************************************
+
+
+//-----------------------------
+int main(int argc, char** argv)
+//-----------------------------
+{
+    try
+    {
+        // Separate the global options from the command
+        bool headless(false);
+        std::vector<std::string> argument_set;
+
+        // Called through a link named after an operation
+        std::string program_name(getBaseName(argv[0]));
+        if (findOperation(program_name))
+        {
+            argument_set.push_back(program_name);
+        }
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+
+            if (argument == "--headless")
+            {
+                headless = true;
+            }
+            else
+            {
+                argument_set.push_back(argument);
+            }
+        }
+
+        // No command
+        if (argument_set.empty())
+        {
+            throw getUsage(argv[0]);
+        }
+
+        // The jobs are always run without display
+        if (argument_set[0] == "batch")
+        {
+            if (argument_set.size() != 2)
+            {
+                throw getUsage(argv[0]);
+            }
+
+            return runBatch(argument_set[1]);
+        }
+
+        runCommand(argument_set, headless);
+    }
+    // An error occured
+    catch (const std::exception& error)
+    {
+        // Display an error message in the console
+        cerr << error.what() << endl;
+        return EXIT_FAILURE;
+    }
+    catch (const std::string& error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+        return EXIT_FAILURE;
+    }
+    catch (const char* error)
+    {
+        // Display an error message in the console
+        cerr << error << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Exit the program
+    return EXIT_SUCCESS;
+}
+
+
+//---------------------------------------------------
+std::string getUsage(const std::string& program_name)
+//---------------------------------------------------
+{
+    std::string usage;
+    usage  = "usage: ";
+    usage += program_name;
+    usage += " [--headless] <command> <input_image> <output_image> [--key=value ...] [--scale=1|2|4|8]";
+    usage += "\n       ";
+    usage += program_name;
+    usage += " [--headless] run <command[:key=value...]>,<command...>,... <input_image> <output_image> [--scale=1|2|4|8]";
+    usage += "\n       ";
+    usage += program_name;
+    usage += " batch <job_file|->  (one command per line, without display)";
+    usage += "\ncommands:";
+
+    for (const Operation* p_operation = getOperationSet(); p_operation->name; ++p_operation)
+    {
+        usage += "\n    ";
+        usage += p_operation->name;
+        usage += std::string(10 - std::string(p_operation->name).size(), ' ');
+        usage += p_operation->description;
+    }
+
+    return usage;
+}
+
+
+//----------------------------------------------
+std::string getBaseName(const std::string& path)
+//----------------------------------------------
+{
+    std::string base_name(path.substr(path.find_last_of("/\\") + 1));
+
+    // Remove the extension (e.g. .exe)
+    std::string::size_type extension = base_name.find_last_of('.');
+    if (extension != std::string::npos)
+    {
+        base_name = base_name.substr(0, extension);
+    }
+
+    return base_name;
+}
+
+
+//--------------------------------------------------------------------------
+void runCommand(const std::vector<std::string>& argument_set, bool headless)
+//--------------------------------------------------------------------------
+{
+    // A single operation is a pipeline with one stage
+    bool chain(argument_set[0] == "run");
+    unsigned int first_argument(chain ? 2 : 1);
+
+    if (chain && argument_set.size() < 2)
+    {
+        throw std::string("usage: run <command[:key=value...]>,<command...>,... <input_image> <output_image>");
+    }
+
+    if (!chain && !findOperation(argument_set[0]))
+    {
+        throw std::string("Unknown command \"") + argument_set[0] + "\".";
+    }
+
+    OperationPipeline pipeline(argument_set[chain ? 1 : 0]);
+
+    // Separate the parameters from the file names
+    int scale_denominator(1);
+    std::vector<std::string> file_name_set;
+    for (unsigned int i = first_argument; i < argument_set.size(); ++i)
+    {
+        const std::string& argument(argument_set[i]);
+
+        if (argument.find("--") != 0)
+        {
+            file_name_set.push_back(argument);
+        }
+        // The parameters of a chain are given with each stage
+        else if (!parseScaleOption(argument, scale_denominator))
+        {
+            if (chain)
+            {
+                throw std::string("Unknown option \"") + argument + "\", the parameters follow the commands, e.g. gaussian:r=2.";
+            }
+
+            pipeline.setParameter(argument.substr(2));
+        }
+    }
+
+    if (file_name_set.size() != 2)
+    {
+        throw std::string("usage: ") + argument_set[0] + (chain ? " <commands>" : "") + " <input_image> <output_image> [--key=value ...]";
+    }
+
+    // Only decode what the first operation uses
+    cv::Mat image = loadImage(file_name_set[0], pipeline.getInputChannels(), scale_denominator);
+
+    // The image has not been loaded
+    if (!image.data)
+    {
+        throw std::string("Could not open or find the image \"") + file_name_set[0] + "\".";
+    }
+
+    // No intermediate image is encoded
+    const cv::Mat& output_image(pipeline.run(image));
+
+    if (!cv::imwrite(file_name_set[1], output_image))
+    {
+        throw std::string("Could not write the image \"") + file_name_set[1] + "\".";
+    }
+
+    // Display the result
+    if (!headless)
+    {
+        cv::namedWindow(file_name_set[1], cv::WINDOW_AUTOSIZE);
+        cv::imshow(file_name_set[1], output_image);
+        cv::waitKey(0);
+    }
+}
+
+
+//--------------------------------------------
+int runBatch(const std::string& job_file_name)
+//--------------------------------------------
+{
+    // Read the jobs from the standard input or from a file
+    std::ifstream job_file;
+    if (job_file_name != "-")
+    {
+        job_file.open(job_file_name.c_str());
+
+        if (!job_file.is_open())
+        {
+            throw std::string("Could not open the job file \"") + job_file_name + "\".";
+        }
+    }
+    std::istream& input(job_file_name == "-" ? std::cin : job_file);
+
+    int line_number(0);
+    int failure_count(0);
+    std::string line;
+    while (std::getline(input, line))
+    {
+        ++line_number;
+
+        // The arguments are separated by white spaces, # starts a comment
+        std::vector<std::string> argument_set;
+        std::stringstream line_stream(line.substr(0, line.find('#')));
+        std::string argument;
+        while (line_stream >> argument)
+        {
+            // The jobs are always headless
+            if (argument != "--headless")
+            {
+                argument_set.push_back(argument);
+            }
+        }
+
+        if (argument_set.empty())
+        {
+            continue;
+        }
+
+        // A failed job does not stop the batch
+        try
+        {
+            runCommand(argument_set, true);
+        }
+        catch (const std::exception& error)
+        {
+            cerr << job_file_name << ":" << line_number << ": " << error.what() << endl;
+            ++failure_count;
+        }
+        catch (const std::string& error)
+        {
+            cerr << job_file_name << ":" << line_number << ": " << error << endl;
+            ++failure_count;
+        }
+        catch (const char* error)
+        {
+            cerr << job_file_name << ":" << line_number << ": " << error << endl;
+            ++failure_count;
+        }
+    }
+
+    if (failure_count)
+    {
+        cerr << failure_count << " job(s) failed." << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}